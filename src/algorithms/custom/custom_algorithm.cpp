@@ -13,12 +13,12 @@ CustomScheduler::CustomScheduler(int slice) {
     // TODO
 }
 
-std::shared_ptr<SchedulingDecision> CustomScheduler::get_next_thread() {
+SchedulingDecision CustomScheduler::get_next_thread() {
     // TODO
-    return nullptr;
+    return SchedulingDecision();
 }
 
-void CustomScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
+void CustomScheduler::add_to_ready_queue(Thread* thread) {
     // TODO
 }
 
@@ -26,3 +26,7 @@ size_t CustomScheduler::size() const {
     // TODO
     return 0;
 }
+
+void CustomScheduler::ready_threads(std::vector<Thread*>& threads) const {
+    // TODO
+}
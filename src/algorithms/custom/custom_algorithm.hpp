@@ -30,12 +30,14 @@ public:
 
     CustomScheduler(int slice = -1);
 
-    std::shared_ptr<SchedulingDecision> get_next_thread();
+    SchedulingDecision get_next_thread();
 
-    void add_to_ready_queue(std::shared_ptr<Thread> thread);
+    void add_to_ready_queue(Thread* thread);
 
     size_t size() const;
 
+    void ready_threads(std::vector<Thread*>& threads) const;
+
 };
 
 #endif
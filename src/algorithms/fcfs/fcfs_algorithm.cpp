@@ -17,27 +17,27 @@ FCFSScheduler::FCFSScheduler(int slice) {
     time_slice = -1;
 }
 
-std::shared_ptr<SchedulingDecision> FCFSScheduler::get_next_thread() {
-    int num_threads = thread_queue.size();
-    std::shared_ptr<Thread> thread;
-    if(num_threads == 0){
-        thread = nullptr;
+SchedulingDecision FCFSScheduler::get_next_thread() {
+    SchedulingDecision sd;
+    sd.time_slice = -1;
+    sd.queue_sizes[0] = thread_queue.size();
+    if(!thread_queue.empty()){
+        sd.thread = thread_queue.pop();
+        sd.reason = RUN_TO_COMPLETION;
     }
-    else{
-        thread = thread_queue.front();
-        thread_queue.pop();
-    }
-    std::shared_ptr<SchedulingDecision> sd = std::make_shared<SchedulingDecision>();
-    sd->thread = thread;
-    sd->explanation = "Selected from " + std::to_string(num_threads) + " threads. Will run to completion of burst.";
-    sd->time_slice = -1;
     return sd;
 }
 
-void FCFSScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
+void FCFSScheduler::add_to_ready_queue(Thread* thread) {
     thread_queue.push(thread);
 }
 
 size_t FCFSScheduler::size() const {
     return thread_queue.size();
-}
\ No newline at end of file
+}
+
+void FCFSScheduler::ready_threads(std::vector<Thread*>& threads) const {
+    for (size_t i = 0; i < thread_queue.size(); i++) {
+        threads.push_back(thread_queue[i]);
+    }
+}
@@ -2,7 +2,6 @@
 #define FCFS_ALGORITHM_HPP
 
 #include <memory>
-#include <queue>
 #include "algorithms/scheduling_algorithm.hpp"
 
 /*
@@ -23,7 +22,7 @@ public:
     //==================================================
 
     // Add any member variables you may need.
-    std::queue<std::shared_ptr<Thread>> thread_queue; //holds the threads to be scheduled
+    ReadyQueue thread_queue; //holds the threads to be scheduled
 
     //==================================================
     //  Member functions
@@ -31,12 +30,14 @@ public:
 
     FCFSScheduler(int slice = -1);
 
-    std::shared_ptr<SchedulingDecision> get_next_thread();
+    SchedulingDecision get_next_thread();
 
-    void add_to_ready_queue(std::shared_ptr<Thread> thread);
+    void add_to_ready_queue(Thread* thread);
 
     size_t size() const;
 
+    void ready_threads(std::vector<Thread*>& threads) const;
+
 };
 
 #endif
@@ -19,12 +19,12 @@ MFLQScheduler::MFLQScheduler(int slice) {
     }
 }
 
-std::shared_ptr<SchedulingDecision> MFLQScheduler::get_next_thread() {
+SchedulingDecision MFLQScheduler::get_next_thread() {
     // TODO
-    return nullptr;
+    return SchedulingDecision();
 }
 
-void MFLQScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
+void MFLQScheduler::add_to_ready_queue(Thread* thread) {
     // TODO
 }
 
@@ -32,3 +32,7 @@ size_t MFLQScheduler::size() const {
     return queue_0.size() + queue_1.size() + queue_2.size() + queue_3.size() + queue_4.size() + 
         queue_5.size() + queue_6.size() + queue_7.size() + queue_8.size() + queue_9.size();
 }
+
+void MFLQScheduler::ready_threads(std::vector<Thread*>& threads) const {
+    // TODO
+}
@@ -20,16 +20,16 @@ public:
     //==================================================
 
     // Add any member variables you may need.
-    std::queue<std::shared_ptr<Thread>> queue_0;
-    std::queue<std::shared_ptr<Thread>> queue_1;
-    std::queue<std::shared_ptr<Thread>> queue_2;
-    std::queue<std::shared_ptr<Thread>> queue_3;
-    std::queue<std::shared_ptr<Thread>> queue_4;
-    std::queue<std::shared_ptr<Thread>> queue_5;
-    std::queue<std::shared_ptr<Thread>> queue_6;
-    std::queue<std::shared_ptr<Thread>> queue_7;
-    std::queue<std::shared_ptr<Thread>> queue_8;
-    std::queue<std::shared_ptr<Thread>> queue_9;
+    ReadyQueue queue_0;
+    ReadyQueue queue_1;
+    ReadyQueue queue_2;
+    ReadyQueue queue_3;
+    ReadyQueue queue_4;
+    ReadyQueue queue_5;
+    ReadyQueue queue_6;
+    ReadyQueue queue_7;
+    ReadyQueue queue_8;
+    ReadyQueue queue_9;
 
 
     //==================================================
@@ -38,12 +38,14 @@ public:
 
     MFLQScheduler(int slice = -1);
 
-    std::shared_ptr<SchedulingDecision> get_next_thread();
+    SchedulingDecision get_next_thread();
 
-    void add_to_ready_queue(std::shared_ptr<Thread> thread);
+    void add_to_ready_queue(Thread* thread);
 
     size_t size() const;
 
+    void ready_threads(std::vector<Thread*>& threads) const;
+
 };
 
 #endif
@@ -18,52 +18,27 @@ PRIORITYScheduler::PRIORITYScheduler(int slice) {
     time_slice = -1;
 }
 
-std::shared_ptr<SchedulingDecision> PRIORITYScheduler::get_next_thread() {
-    int total_queue_size = size();
-    std::shared_ptr<Thread> thread = nullptr;
-    std::string message = "";
-    if(system_queue.size() != 0){
-        message = "Selected from SYSTEM queue. ";
-        message = message + message_builder();
-        thread = system_queue.front();
-        system_queue.pop();
-        message = message + " -> " + message_builder();
+SchedulingDecision PRIORITYScheduler::get_next_thread() {
+    SchedulingDecision sd;
+    sd.time_slice = time_slice;
+    sd.queue_sizes[SYSTEM] = system_queue.size();
+    sd.queue_sizes[INTERACTIVE] = interactive_queue.size();
+    sd.queue_sizes[NORMAL] = normal_queue.size();
+    sd.queue_sizes[BATCH] = batch_queue.size();
+    //take from the highest priority queue that has a thread
+    ReadyQueue* queues[4] = {&system_queue, &interactive_queue, &normal_queue, &batch_queue};
+    for(int i = SYSTEM; i <= BATCH; i++){
+        if(!queues[i]->empty()){
+            sd.thread = queues[i]->pop();
+            sd.reason = PRIORITY_QUEUE;
+            sd.queue = i;
+            break;
+        }
     }
-    else if(interactive_queue.size() != 0){
-        message = "Selected from INTERACTIVE queue. ";
-        message = message + message_builder();
-        thread = interactive_queue.front();
-        interactive_queue.pop();
-        message = message + " -> " + message_builder();
-    }
-    else if(normal_queue.size() != 0){
-        message = "Selected from NORMAL queue. ";
-        message = message + message_builder();
-        thread = normal_queue.front();
-        normal_queue.pop();
-        message = message + " -> " + message_builder();
-    }
-    else if(batch_queue.size() != 0){
-        message = "Selected from BATCH queue. ";
-        message = message + message_builder();
-        thread = batch_queue.front();
-        batch_queue.pop();
-        message = message + " -> " + message_builder();
-    }
-    std::shared_ptr<SchedulingDecision> sd = std::make_shared<SchedulingDecision>();
-    sd->thread = thread;
-    sd->explanation = message;
-    sd->time_slice = time_slice;
     return sd;
-
 }
 
-std::string PRIORITYScheduler::message_builder(){
-    return "[S: " + std::to_string(system_queue.size()) + " I: " + std::to_string(interactive_queue.size()) + 
-        " N: " + std::to_string(normal_queue.size()) + " B: " + std::to_string(batch_queue.size()) + "]";
-}
-
-void PRIORITYScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
+void PRIORITYScheduler::add_to_ready_queue(Thread* thread) {
     //add the thread to the appropriate queue
     if(thread->priority == SYSTEM){
         system_queue.push(thread);
@@ -82,3 +57,13 @@ void PRIORITYScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
 size_t PRIORITYScheduler::size() const {
     return system_queue.size() + interactive_queue.size() + normal_queue.size() + batch_queue.size();
 }
+
+void PRIORITYScheduler::ready_threads(std::vector<Thread*>& threads) const {
+    //each thread goes back to the queue of its priority, so the queues can simply be listed in turn
+    const ReadyQueue* queues[4] = {&system_queue, &interactive_queue, &normal_queue, &batch_queue};
+    for (const ReadyQueue* queue : queues) {
+        for (size_t i = 0; i < queue->size(); i++) {
+            threads.push_back((*queue)[i]);
+        }
+    }
+}
@@ -25,26 +25,26 @@ public:
     //==================================================
 
     // Add any member variables you may need.
-    std::queue<std::shared_ptr<Thread>> system_queue;
-    std::queue<std::shared_ptr<Thread>> interactive_queue;
-    std::queue<std::shared_ptr<Thread>> normal_queue;
-    std::queue<std::shared_ptr<Thread>> batch_queue;
+    ReadyQueue system_queue;
+    ReadyQueue interactive_queue;
+    ReadyQueue normal_queue;
+    ReadyQueue batch_queue;
 
 
     //==================================================
     //  Member functions
     //==================================================
 
-    std::string message_builder(); //helper function for building scheduling decision messages
-
     PRIORITYScheduler(int slice = -1);
 
-    std::shared_ptr<SchedulingDecision> get_next_thread();
+    SchedulingDecision get_next_thread();
 
-    void add_to_ready_queue(std::shared_ptr<Thread> thread);
+    void add_to_ready_queue(Thread* thread);
 
     size_t size() const;
 
+    void ready_threads(std::vector<Thread*>& threads) const;
+
 };
 
 #endif
@@ -17,27 +17,27 @@ RRScheduler::RRScheduler(int slice) {
     }
 }
 
-std::shared_ptr<SchedulingDecision> RRScheduler::get_next_thread() {
-    int num_threads = thread_queue.size();
-    std::shared_ptr<Thread> thread;
-    if(num_threads == 0){
-        thread = nullptr;
+SchedulingDecision RRScheduler::get_next_thread() {
+    SchedulingDecision sd;
+    sd.time_slice = this->time_slice;
+    sd.queue_sizes[0] = thread_queue.size();
+    if(!thread_queue.empty()){
+        sd.thread = thread_queue.pop();
+        sd.reason = TIME_SLICE;
     }
-    else{
-        thread = thread_queue.front();
-        thread_queue.pop();
-    }
-    std::shared_ptr<SchedulingDecision> sd = std::make_shared<SchedulingDecision>();
-    sd->thread = thread;
-    sd->explanation = "Selected from " + std::to_string(num_threads) + " threads. Will run for at most " + std::to_string(time_slice) + " ticks.";
-    sd->time_slice = this->time_slice;
     return sd;
 }
 
-void RRScheduler::add_to_ready_queue(std::shared_ptr<Thread> thread) {
+void RRScheduler::add_to_ready_queue(Thread* thread) {
     thread_queue.push(thread);
 }
 
 size_t RRScheduler::size() const {
     return thread_queue.size();
 }
+
+void RRScheduler::ready_threads(std::vector<Thread*>& threads) const {
+    for (size_t i = 0; i < thread_queue.size(); i++) {
+        threads.push_back(thread_queue[i]);
+    }
+}
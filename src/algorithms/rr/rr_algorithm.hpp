@@ -2,7 +2,6 @@
 #define RR_ALGORITHM_HPP
 
 #include <memory>
-#include <queue>
 #include <stdexcept>
 #include "algorithms/scheduling_algorithm.hpp"
 
@@ -24,7 +23,7 @@ public:
     //==================================================
 
     // Add any member variables you may need.
-    std::queue<std::shared_ptr<Thread>> thread_queue; //holds the threads to be scheduled
+    ReadyQueue thread_queue; //holds the threads to be scheduled
 
     //==================================================
     //  Member functions
@@ -32,11 +31,13 @@ public:
 
     RRScheduler(int slice = 3);
 
-    std::shared_ptr<SchedulingDecision> get_next_thread();
+    SchedulingDecision get_next_thread();
 
-    void add_to_ready_queue(std::shared_ptr<Thread> thread);
+    void add_to_ready_queue(Thread* thread);
 
     size_t size() const;
+
+    void ready_threads(std::vector<Thread*>& threads) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "algorithms/scheduler_registry.hpp"
+#include "types/thread/thread.hpp"
+#include "utilities/memory/allocation_counter.hpp"
+#include "utilities/microbench/microbench.hpp"
+
+/*
+    Benchmarks add_to_ready_queue and get_next_thread of every registered scheduler,
+    so new schedulers are covered as soon as they are registered. The scheduler is
+    filled to the requested depth first, and the depth is then held there while
+    timing:
+        <algorithm>/pick_add: each pick is followed by re-adding the picked thread,
+            so every pick sees exactly the requested depth.
+        <algorithm>/add, <algorithm>/pick: the operation alone, timed in chunks with
+            the opposite operation run untimed in between, so the depth stays within
+            a chunk of the requested one.
+    Threads get random priorities.
+*/
+
+// The most operations timed in a row by the add and pick benchmarks.
+static const size_t CHUNK = 64;
+
+static MicrobenchResult make_result(const std::string& name, size_t depth, size_t ops, uint64_t elapsed_ns,
+                                    size_t allocations, double depth_sum, size_t max_depth) {
+    MicrobenchResult result;
+    result.name = name;
+    result.depth = depth;
+    result.ops = ops;
+    result.mean_depth = ops == 0 ? 0.0 : depth_sum / ops;
+    result.max_depth = max_depth;
+    result.ns_per_op = ops == 0 ? 0.0 : (double) elapsed_ns / ops;
+    result.allocations_per_op = ops == 0 ? 0.0 : (double) allocations / ops;
+    return result;
+}
+
+static uint64_t nanoseconds_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static std::vector<MicrobenchResult> benchmark_scheduler(const std::string& algorithm, size_t depth, const MicrobenchOptions& options) {
+    std::mt19937_64 random(options.seed);
+    std::uniform_int_distribution<int> priority(SYSTEM, BATCH);
+    depth = std::max<size_t>(1, depth);
+
+    // Enough threads for the depth plus a chunk of adds on top of it.
+    std::vector<Thread> threads;
+    threads.reserve(depth + CHUNK);
+    for (size_t i = 0; i < depth + CHUNK; ++i) {
+        threads.emplace_back(0, (int) i, 0, (ProcessPriority) priority(random));
+    }
+
+    auto scheduler = create_scheduler(algorithm, is_preemptive_algorithm(algorithm) ? options.time_slice : -1);
+    for (size_t i = 0; i < depth; ++i) {
+        scheduler->add_to_ready_queue(&threads[i]);
+    }
+    // The threads that are not in the scheduler.
+    std::vector<Thread*> spare;
+    spare.reserve(threads.size());
+    for (size_t i = depth; i < threads.size(); ++i) {
+        spare.push_back(&threads[i]);
+    }
+
+    std::vector<MicrobenchResult> results;
+
+    // Picks and re-adds in pairs: each pick sees depth threads, each add depth - 1.
+    size_t pairs = options.ops / 2;
+    size_t allocations_before = allocation_count();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pairs; ++i) {
+        SchedulingDecision sd = scheduler->get_next_thread();
+        scheduler->add_to_ready_queue(sd.thread);
+    }
+    auto end = std::chrono::steady_clock::now();
+    results.push_back(make_result(algorithm + "/pick_add", depth, pairs * 2, nanoseconds_between(start, end),
+        allocation_count() - allocations_before, pairs * (2.0 * depth - 1), depth));
+
+    // Adds from depth up to depth + CHUNK - 1, with untimed picks taking the queue back down.
+    uint64_t elapsed_ns = 0;
+    size_t allocations = 0;
+    double depth_sum = 0.0;
+    size_t max_depth = 0;
+    for (size_t done = 0; done < options.ops;) {
+        size_t count = std::min(CHUNK, options.ops - done);
+        allocations_before = allocation_count();
+        start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < count; ++j) {
+            scheduler->add_to_ready_queue(spare[spare.size() - 1 - j]);
+        }
+        end = std::chrono::steady_clock::now();
+        elapsed_ns += nanoseconds_between(start, end);
+        allocations += allocation_count() - allocations_before;
+        spare.resize(spare.size() - count);
+
+        depth_sum += count * (double) depth + count * (count - 1) / 2.0;
+        max_depth = std::max(max_depth, depth + count - 1);
+        for (size_t j = 0; j < count; ++j) {
+            spare.push_back(scheduler->get_next_thread().thread);
+        }
+        done += count;
+    }
+    results.push_back(make_result(algorithm + "/add", depth, options.ops, elapsed_ns, allocations, depth_sum, max_depth));
+
+    // Picks from depth down to depth - CHUNK + 1, with untimed adds filling the queue back up.
+    elapsed_ns = 0;
+    allocations = 0;
+    depth_sum = 0.0;
+    max_depth = 0;
+    for (size_t done = 0; done < options.ops;) {
+        size_t count = std::min({CHUNK, depth, options.ops - done});
+        allocations_before = allocation_count();
+        start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < count; ++j) {
+            spare.push_back(scheduler->get_next_thread().thread);
+        }
+        end = std::chrono::steady_clock::now();
+        elapsed_ns += nanoseconds_between(start, end);
+        allocations += allocation_count() - allocations_before;
+
+        depth_sum += count * (double) depth - count * (count - 1) / 2.0;
+        max_depth = depth;
+        for (size_t j = 0; j < count; ++j) {
+            scheduler->add_to_ready_queue(spare.back());
+            spare.pop_back();
+        }
+        done += count;
+    }
+    results.push_back(make_result(algorithm + "/pick", depth, options.ops, elapsed_ns, allocations, depth_sum, max_depth));
+
+    return results;
+}
+
+static std::vector<MicrobenchResult> scheduler_benchmarks(const MicrobenchOptions& options) {
+    std::vector<MicrobenchResult> results;
+
+    for (const std::string& algorithm : registered_algorithms()) {
+        for (size_t depth : options.depths) {
+            for (const MicrobenchResult& result : benchmark_scheduler(algorithm, depth, options)) {
+                results.push_back(result);
+            }
+        }
+    }
+    return results;
+}
+
+REGISTER_MICROBENCHMARK("scheduler", scheduler_benchmarks);
@@ -0,0 +1,61 @@
+#include "algorithms/scheduler_registry.hpp"
+
+#include "algorithms/fcfs/fcfs_algorithm.hpp"
+#include "algorithms/rr/rr_algorithm.hpp"
+#include "algorithms/priority/priority_algorithm.hpp"
+#include "algorithms/mlfq/mlfq_algorithm.hpp"
+#include "algorithms/custom/custom_algorithm.hpp"
+
+/*
+    SchedulerEntry:
+        A registered algorithm: its name, whether it is preemptive and how to build it.
+*/
+struct SchedulerEntry {
+    const char* name;
+    bool preemptive;
+    std::shared_ptr<Scheduler> (*create)(int time_slice);
+};
+
+// MLFQ and CUSTOM are not registered until they are implemented.
+static const SchedulerEntry SCHEDULERS[] = {
+    {"FCFS", false, [](int) -> std::shared_ptr<Scheduler> { return std::make_shared<FCFSScheduler>(); }},
+    {"RR", true, [](int slice) -> std::shared_ptr<Scheduler> { return std::make_shared<RRScheduler>(slice); }},
+    {"PRIORITY", false, [](int) -> std::shared_ptr<Scheduler> { return std::make_shared<PRIORITYScheduler>(); }},
+};
+
+static const SchedulerEntry* find_scheduler(const std::string& name) {
+    for (const SchedulerEntry& entry : SCHEDULERS) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<std::string>& registered_algorithms() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> list;
+        for (const SchedulerEntry& entry : SCHEDULERS) {
+            list.push_back(entry.name);
+        }
+        return list;
+    }();
+    return names;
+}
+
+bool is_registered_algorithm(const std::string& name) {
+    return find_scheduler(name) != nullptr;
+}
+
+bool is_preemptive_algorithm(const std::string& name) {
+    const SchedulerEntry* entry = find_scheduler(name);
+    return entry != nullptr && entry->preemptive;
+}
+
+std::shared_ptr<Scheduler> create_scheduler(const std::string& name, int time_slice) {
+    const SchedulerEntry* entry = find_scheduler(name);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    return entry->create(entry->preemptive ? time_slice : -1);
+}
@@ -0,0 +1,45 @@
+#ifndef SCHEDULER_REGISTRY_HPP
+#define SCHEDULER_REGISTRY_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithms/scheduling_algorithm.hpp"
+
+/*
+    Scheduler registry:
+        The one place that maps algorithm names (as given with -a) to scheduler
+        implementations. Anything that needs "every algorithm" (the comparison mode,
+        benchmarks) iterates over registered_algorithms(), so adding a scheduler here
+        is all it takes for those tools to pick it up.
+*/
+
+/*
+    registered_algorithms():
+        The names of the algorithms that have a working implementation, in the order
+        they should be listed.
+*/
+const std::vector<std::string>& registered_algorithms();
+
+/*
+    is_registered_algorithm(name):
+        True if create_scheduler can build a scheduler for the given name.
+*/
+bool is_registered_algorithm(const std::string& name);
+
+/*
+    is_preemptive_algorithm(name):
+        True if the algorithm takes a time slice (set with -s).
+*/
+bool is_preemptive_algorithm(const std::string& name);
+
+/*
+    create_scheduler(name, time_slice):
+        Creates a new scheduler for the named algorithm. The time slice is only passed
+        on to preemptive algorithms. Returns nullptr for algorithms that are not
+        registered.
+*/
+std::shared_ptr<Scheduler> create_scheduler(const std::string& name, int time_slice);
+
+#endif
@@ -2,10 +2,21 @@
 #define SCHEDULING_ALGORITHM_HPP
 
 #include <memory>
+#include <vector>
 #include "types/enums.hpp"
 #include "types/event/event.hpp"
 #include "types/scheduling_decision/scheduling_decision.hpp"
 #include "types/thread/thread.hpp"
+#include "utilities/ring_buffer/ring_buffer.hpp"
+
+/*
+    ReadyQueue:
+        The queue type the schedulers use to hold ready threads. It is a ring buffer,
+        so pushing and popping threads does not allocate once the queue has grown to
+        the largest number of threads that are ready at the same time. The queue only
+        holds handles; the threads themselves are owned by their process.
+*/
+using ReadyQueue = RingBuffer<Thread*>;
 
 /*
     Scheduler:
@@ -39,16 +50,19 @@ public:
         get_next_thread():
             This function tries to get the next thread to run based on the scheduling algorithm.
 
-            It returns a SchedulingDecision object (see the SchedulingDecision class for more info)
-            that contains:
+            It returns a SchedulingDecision object by value (see the SchedulingDecision class for
+            more info) that contains:
                 The next thread, or nullptr if no thread is available.
                 The time slice if the algorithm is preemptive.
-                A message explaining the decision.
+                A reason code and the ready queue sizes, from which a message explaining the
+                decision can be built.
                     This might be, for the first come, first served algorithm, something like this:
                         "Selected from 9 threads. Will run to completion of burst."
                     This message is used when printing the state transitions (see the Logger class).
+
+            This is called every time the dispatcher runs, so it should not allocate.
     */
-    virtual std::shared_ptr<SchedulingDecision> get_next_thread() = 0;
+    virtual SchedulingDecision get_next_thread() = 0;
 
     /*
         add_to_ready_queue(Thread):
@@ -57,7 +71,7 @@ public:
             algorithms you may have multiple queues, and there may be more logic involved in determining
             which queue the thread should be placed in.
     */
-    virtual void add_to_ready_queue(std::shared_ptr<Thread> thread) = 0;
+    virtual void add_to_ready_queue(Thread* thread) = 0;
 
     /*
         size():
@@ -65,6 +79,14 @@ public:
     */
     virtual size_t size() const = 0;
 
+    /*
+        ready_threads(threads):
+            Appends every thread in the ready queue(s) to threads, in an order such that
+            adding them back with add_to_ready_queue to a fresh scheduler of the same kind
+            rebuilds exactly the same queues. Used to save a run in a checkpoint.
+    */
+    virtual void ready_threads(std::vector<Thread*>& threads) const = 0;
+
     /*
         empty():
             This function returns a true boolean value if the scheduler has no more threads in
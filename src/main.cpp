@@ -2,6 +2,7 @@
 #include <string>
 
 #include "utilities/flags/flags.hpp"
+#include "simulation/comparison.hpp"
 #include "simulation/simulation.hpp"
 
 int main(int argc, char** argv) {
@@ -16,6 +17,11 @@ int main(int argc, char** argv) {
     }
 
     try {
+        if (flags.compare) {
+            run_comparison(flags);
+            return 0;
+        }
+
         Simulation simulation(flags);
         simulation.run();
      } catch (...) {
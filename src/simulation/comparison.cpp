@@ -0,0 +1,121 @@
+#include "simulation/comparison.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+#include "algorithms/scheduler_registry.hpp"
+#include "simulation/simulation.hpp"
+#include "utilities/logger/logger.hpp"
+#include "utilities/temp_file/temp_file.hpp"
+
+// The configuration of one run in compare mode.
+static FlagOptions run_config(const FlagOptions& flags, const std::string& algorithm) {
+    FlagOptions config;
+    config.filename = flags.filename;
+    config.generate = flags.generate;
+    config.scheduler = algorithm;
+    config.time_slice = is_preemptive_algorithm(algorithm) ? flags.time_slice : -1;
+    config.branch_at = flags.branch_at;
+    return config;
+}
+
+std::vector<ComparisonResult> compare_algorithms(std::shared_ptr<const Workload> workload, const FlagOptions& flags) {
+    const std::vector<std::string>& algorithms = registered_algorithms();
+    std::vector<ComparisonResult> results(algorithms.size());
+
+    // The shared prefix is simulated up to the branch point and saved there (by
+    // the checkpoint a run stopped by max_time leaves), for every run to resume.
+    std::string snapshot;
+    if (flags.branch_at != 0) {
+        snapshot = temporary_file("cpu-sim-branch");
+        FlagOptions config = run_config(flags, flags.scheduler);
+        config.max_time = flags.branch_at;
+        config.checkpoint_file = snapshot;
+
+        Simulation simulation(workload, config);
+        SystemStats stats = simulation.run(config);
+
+        if (simulation.run_info.stop_reason.empty()) {
+            // Everything happened before the branch point, so every run is this one.
+            std::remove(snapshot.c_str());
+            for (size_t i = 0; i < algorithms.size(); i++) {
+                results[i].algorithm = algorithms[i];
+                results[i].stats = stats;
+                results[i].info = simulation.run_info;
+                results[i].info.algorithm = algorithms[i];
+            }
+            return results;
+        }
+    }
+
+    // Workers pull the next algorithm to simulate until there are none left.
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < algorithms.size(); i = next++) {
+            FlagOptions config = run_config(flags, algorithms[i]);
+            config.restore_file = snapshot;
+
+            Simulation simulation(workload, config);
+            results[i].algorithm = algorithms[i];
+            results[i].stats = simulation.run(config);
+            results[i].info = simulation.run_info;
+        }
+    };
+
+    size_t num_workers = std::min<size_t>(algorithms.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (!snapshot.empty()) {
+        std::remove(snapshot.c_str());
+    }
+    return results;
+}
+
+void run_comparison(const FlagOptions& flags) {
+    if (!is_registered_algorithm(flags.baseline)) {
+        std::cerr << "Cannot compare against " << flags.baseline << ": it is not implemented." << std::endl;
+        throw(std::logic_error("Bad baseline."));
+    }
+
+    if (flags.branch_at != 0 && !is_registered_algorithm(flags.scheduler)) {
+        std::cerr << "Cannot branch from a run of " << flags.scheduler << ": it is not implemented." << std::endl;
+        throw(std::logic_error("Bad algorithm."));
+    }
+
+    auto workload = Simulation::load_workload(flags);
+    std::vector<ComparisonResult> results = compare_algorithms(workload, flags);
+
+    if (flags.format == "json") {
+        std::string message = "[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            message += (i == 0) ? "" : ",\n ";
+            Logger::format_json_report(message, results[i].stats, results[i].info);
+        }
+        std::cout << message << "]\n";
+        return;
+    }
+
+    std::vector<std::string> algorithms;
+    std::vector<SystemStats> stats;
+    size_t baseline = 0;
+    for (const ComparisonResult& result : results) {
+        if (result.algorithm == flags.baseline) {
+            baseline = algorithms.size();
+        }
+        algorithms.push_back(result.algorithm);
+        stats.push_back(result.stats);
+    }
+
+    Logger logger(false, false, true);
+    logger.print_comparison(algorithms, stats, baseline);
+}
@@ -0,0 +1,67 @@
+#ifndef COMPARISON_HPP
+#define COMPARISON_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types/run_info/run_info.hpp"
+#include "types/system_stats/system_stats.hpp"
+#include "types/workload/workload.hpp"
+#include "utilities/flags/flags.hpp"
+
+/*
+    ComparisonResult:
+        The outcome of simulating one algorithm in compare mode.
+*/
+
+class ComparisonResult {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        algorithm:
+            The name of the algorithm that was simulated.
+    */
+    std::string algorithm;
+
+    /*
+        stats:
+            The statistics of the run.
+    */
+    SystemStats stats;
+
+    /*
+        info:
+            The configuration of the run and the simulator's work on it.
+    */
+    RunInfo info;
+};
+
+/*
+    compare_algorithms(workload, flags):
+        Simulates the workload once with every registered algorithm and returns the
+        results in registration order. The runs share the (read-only) workload and are
+        spread over the available cores. The time slice in flags is passed to the
+        preemptive algorithms; the output flags are ignored.
+
+        With flags.branch_at, the run is first simulated once with flags.scheduler up
+        to that time and checkpointed in a temporary file, and every algorithm resumes
+        from the checkpoint, switching scheduler there with the ready threads queued in
+        the same order. Throws std::logic_error if the checkpoint cannot be written.
+*/
+std::vector<ComparisonResult> compare_algorithms(std::shared_ptr<const Workload> workload, const FlagOptions& flags);
+
+/*
+    run_comparison(flags):
+        Implements the -c, --compare mode: reads the simulation file once, compares
+        every registered algorithm on it and prints the comparison table relative to
+        flags.baseline (or, with --format json, a JSON array of the runs' reports). Throws std::logic_error if the baseline (or, with
+        --branch_at, the algorithm of the shared prefix) is not a registered algorithm.
+*/
+void run_comparison(const FlagOptions& flags);
+
+#endif
@@ -1,205 +1,656 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
-#include "algorithms/fcfs/fcfs_algorithm.hpp"
-#include "algorithms/rr/rr_algorithm.hpp"
-#include "algorithms/priority/priority_algorithm.hpp"
-#include "algorithms/mlfq/mlfq_algorithm.hpp"
-#include "algorithms/custom/custom_algorithm.hpp"
+#include "algorithms/scheduler_registry.hpp"
 
 #include "simulation/simulation.hpp"
 #include "types/enums.hpp"
 
 #include "utilities/flags/flags.hpp"
+#include "utilities/generator/generator.hpp"
+#include "utilities/memory/allocation_counter.hpp"
+#include "utilities/profiler/profiler.hpp"
+
+// How many times SIGTERM or SIGINT came in while a checkpointed run was going.
+// Only the handler writes it: a run compares it with the count it saw when it
+// started, and if it has moved, saves a checkpoint and stops at the next event.
+static volatile std::sig_atomic_t interrupts = 0;
+
+static void request_interrupt(int) {
+    interrupts = interrupts + 1;
+}
+
+/*
+    InterruptHandlers:
+        Installs request_interrupt for SIGTERM and SIGINT while at least one
+        checkpointed run is going, and puts the previous handlers back when the
+        last of them returns.
+*/
+class InterruptHandlers {
+public:
+    InterruptHandlers() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (users++ == 0) {
+            struct sigaction action = {};
+            action.sa_handler = request_interrupt;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGTERM, &action, &old_term);
+            sigaction(SIGINT, &action, &old_int);
+        }
+    }
+
+    ~InterruptHandlers() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--users == 0) {
+            sigaction(SIGTERM, &old_term, nullptr);
+            sigaction(SIGINT, &old_int, nullptr);
+        }
+    }
+
+    InterruptHandlers(const InterruptHandlers&) = delete;
+    InterruptHandlers& operator=(const InterruptHandlers&) = delete;
+
+private:
+    static std::mutex mutex;
+    static int users;
+    static struct sigaction old_term;
+    static struct sigaction old_int;
+};
+
+std::mutex InterruptHandlers::mutex;
+int InterruptHandlers::users = 0;
+struct sigaction InterruptHandlers::old_term;
+struct sigaction InterruptHandlers::old_int;
+
+// How often (in events) the simulation looks at the clock to see if a checkpoint is due.
+static const uint64_t CHECKPOINT_CHECK_EVENTS = 1 << 16;
+
+static std::chrono::steady_clock::time_point seconds_from_now(double seconds) {
+    return std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
 
 Simulation::Simulation(FlagOptions flags) {
     // Hello!
-    if (flags.scheduler == "FCFS") {
-        // Create a FCFS scheduling algorithm
-        this->scheduler = std::make_shared<FCFSScheduler>();
-    } else if (flags.scheduler == "RR") {
-        // Create a RR scheduling algorithm
-        this->scheduler = std::make_shared<RRScheduler>(flags.time_slice);
-    } else if (flags.scheduler == "PRIORITY") {
-        // Create a PRIORITY scheduling algorithm
-        this->scheduler = std::make_shared<PRIORITYScheduler>();
-    } else if (flags.scheduler == "MLFQ") {
-        // Create a MLFQ scheduling algorithm
-    } else if (flags.scheduler == "CUSTOM") {
-        // Create a custom scheduling algorithm
-    }
-    this->flags = flags;
-    this->logger = Logger(flags.verbose, flags.per_thread, flags.metrics);
+    this->configure(flags);
+    this->reset();
+}
+
+Simulation::Simulation(std::shared_ptr<const Workload> workload, FlagOptions flags) : workload(workload) {
+    this->configure(flags);
+    this->reset();
+}
+
+void Simulation::configure(const FlagOptions& config) {
+    this->flags = config;
+    if (config.arrival_rate > 0) {
+        this->flags.retire = true;
+    }
+    this->logger = Logger(config.verbose, config.per_thread, config.metrics, config.latency, config.verbose_filter);
+    this->logger.output = this->output;
+}
+
+void Simulation::set_output(std::ostream& output) {
+    this->output = &output;
+    this->logger.output = &output;
 }
 
 void Simulation::run() {
-    this->read_file(this->flags.filename);
-    
-    while (!this->events.empty()) {
-        auto event = this->events.top();
-        this->events.pop();
+    if (this->workload == nullptr) {
+        this->workload = load_workload(this->flags);
+    }
 
-        // Invoke the appropriate method in the simulation for the given event type.
+    if (!this->flags.export_file.empty()) {
+        this->exporter = ThreadExporter::open(this->flags.export_file);
+    }
 
-        switch(event->type) {
-            case THREAD_ARRIVED:
-                this->handle_thread_arrived(event);
-                break;
+    if (!this->flags.trace_file.empty()) {
+        this->trace = std::make_unique<TraceWriter>(this->flags.trace_file, *this->workload);
+    }
 
-            case THREAD_DISPATCH_COMPLETED:
-            case PROCESS_DISPATCH_COMPLETED:
-                this->handle_dispatch_completed(event);
-                break;
+    if (!this->flags.chrome_trace_file.empty()) {
+        this->chrome_trace = std::make_unique<ChromeTraceWriter>(this->flags.chrome_trace_file, this->workload);
+    }
+
+    if (this->flags.async_log && (this->flags.verbose || (this->flags.per_thread && this->flags.retire))) {
+        this->async_logger = std::make_unique<AsyncLogger>(this->logger, *this->workload);
+    }
+
+    {
+        std::unique_ptr<InterruptHandlers> handlers;
+        if (!this->flags.checkpoint_file.empty()) {
+            handlers = std::make_unique<InterruptHandlers>();
+        }
+        this->run(this->flags);
+    }
+
+    // Let the logging thread finish before the report is printed.
+    if (this->async_logger != nullptr) {
+        this->async_logger->close();
+        this->async_logger = nullptr;
+    }
+    if (this->exporter != nullptr) {
+        this->exporter->close();
+        this->exporter = nullptr;
+    }
+    if (this->trace != nullptr) {
+        this->trace->close();
+        this->trace = nullptr;
+    }
+    if (this->chrome_trace != nullptr) {
+        this->chrome_trace->close();
+        this->chrome_trace = nullptr;
+    }
+
+    this->report();
+
+    // Hand the run's memory back now rather than when the simulation is destroyed.
+    this->reset();
+}
+
+SystemStats Simulation::run(const FlagOptions& config) {
+    this->start(config);
+
+    auto start = std::chrono::steady_clock::now();
+    this->simulate();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    this->run_info.wall_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    this->run_info.arena_bytes = this->arena.bytes_reserved();
+    if (this->flags.arrival_rate > 0) {
+        this->run_info.num_threads = this->next_arrival;
+    }
+    return this->system_stats;
+}
+
+void Simulation::start(const FlagOptions& config) {
+    this->configure(config);
+    this->reset();
+    this->instantiate_workload();
+    if (!this->flags.restore_file.empty()) {
+        this->restore_checkpoint(this->flags.restore_file);
+    }
+    this->next_checkpoint = seconds_from_now(this->flags.checkpoint_interval);
+    this->interrupts_seen = interrupts;
+
+    this->run_info.filename = this->flags.generate.empty() ? this->flags.filename : "generated: " + this->flags.generate;
+    this->run_info.algorithm = this->flags.scheduler;
+    this->run_info.time_slice = this->scheduler->time_slice;
+    this->run_info.options = this->flags;
+    this->run_info.num_processes = this->workload->processes.size();
+    this->run_info.num_threads = this->workload->threads.size();
+}
+
+void Simulation::reset() {
+    // The per-run objects are never destroyed one by one: they only hold memory
+    // from the arena, which is handed back as a whole below.
+    this->processes.clear();
+    this->process_table = std::pmr::vector<Process*>(&this->arena);
+    this->events = EventQueue(EventComparator(), std::pmr::vector<Event>(&this->arena));
+    this->next_arrival = 0;
+    this->open_arrivals.reset();
+    this->horizon = SIM_TIME_MAX;
+    this->completed_threads = 0;
+    this->convergence.reset();
+    this->converged = false;
+    this->steady_recorder = SteadyStateRecorder(this->flags.batches);
+    this->steady_state = SteadyStateReport();
+    this->retired_thread = nullptr;
+    this->active_thread = nullptr;
+    this->prev_thread = nullptr;
+    this->event_num = 0;
+    this->system_stats = SystemStats();
+    this->run_info = RunInfo();
+    this->profiler = Profiler();
+    // A fresh scheduler, so no threads from a previous run are left in its queues.
+    this->scheduler = create_scheduler(this->flags.scheduler, this->flags.time_slice);
+    this->thread_pool.release();
+    this->large_bursts.release();
+    this->arena.release();
+}
+
+void Simulation::simulate() {
+    size_t allocations_before = allocation_count();
+
+    PROFILE(uint64_t loop_start_ticks = Profiler::now();
+            auto loop_start = std::chrono::steady_clock::now();)
+
+    while (this->step()) {
+    }
+
+    // We are done!
+    this->run_info.event_loop_allocations = allocation_count() - allocations_before;
+    PROFILE(this->profiler.total_ticks = Profiler::now() - loop_start_ticks;
+            this->profiler.total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loop_start).count();)
+
+    this->calculate_statistics();
+}
+
+bool Simulation::step() {
+    Event& event = this->current_event;
+
+    if (!this->run_info.stop_reason.empty()) {
+        return false;
+    }
+
+    const char* limit = nullptr;
+    if (this->flags.max_events != 0 && this->run_info.events_processed >= this->flags.max_events) {
+        limit = "max_events";
+    } else if (this->flags.max_completed != 0 && this->completed_threads >= this->flags.max_completed) {
+        limit = "max_completed";
+    } else if (this->converged) {
+        limit = "converged";
+    } else if (interrupts != this->interrupts_seen && !this->flags.checkpoint_file.empty()) {
+        limit = "interrupted";
+    }
+    if (limit != nullptr) {
+        if (this->work_remaining()) {
+            // Save the run as it stands, so it can be resumed past the limit.
+            if (!this->flags.checkpoint_file.empty()) {
+                this->save_checkpoint(this->flags.checkpoint_file);
+            }
+            this->stop(limit, this->system_stats.total_time);
+        }
+        return false;
+    }
+
+    if (!this->next_event(event)) {
+        // Anything left is past the horizon.
+        if (this->work_remaining()) {
+            bool by_max_time = this->flags.max_time != 0 && this->horizon == this->flags.max_time;
+            if (by_max_time && !this->flags.checkpoint_file.empty()) {
+                this->save_checkpoint(this->flags.checkpoint_file);
+            }
+            this->stop(by_max_time ? "max_time" : "duration", this->horizon);
+        }
+        return false;
+    }
+
+    this->run_info.events_processed++;
+    PROFILE(this->profiler.record_queue_size(this->events.size());
+            uint64_t handler_start = Profiler::now();
+            size_t handler_allocations = allocation_count();)
+
+    // Invoke the appropriate method in the simulation for the given event type.
+
+    switch(event.type) {
+        case THREAD_ARRIVED:
+            this->handle_thread_arrived(event);
+            break;
+
+        case THREAD_DISPATCH_COMPLETED:
+        case PROCESS_DISPATCH_COMPLETED:
+            this->handle_dispatch_completed(event);
+            break;
+
+        case CPU_BURST_COMPLETED:
+            this->handle_cpu_burst_completed(event);
+            break;
+
+        case IO_BURST_COMPLETED:
+            this->handle_io_burst_completed(event);
+            break;
+        case THREAD_COMPLETED:
+            this->handle_thread_completed(event);
+            break;
+
+        case THREAD_PREEMPTED:
+            this->handle_thread_preempted(event);
+            break;
+
+        case DISPATCHER_INVOKED:
+            this->handle_dispatcher_invoked(event);
+            break;
+
+        case NUM_EVENT_TYPES:
+            throw(std::logic_error("Bad event type."));
+    }
+
+    PROFILE(this->profiler.event_counts[event.type]++;
+            this->profiler.handler_ticks[event.type] += Profiler::now() - handler_start;
+            this->profiler.handler_allocations[event.type] += allocation_count() - handler_allocations;)
+
+    // If this event triggered a state change, print it out.
+    if (event.thread && event.thread->current_state != event.thread->previous_state) {
+        if (this->async_logger != nullptr) {
+            if (this->logger.wants_verbose(event, event.thread)) {
+                this->async_logger->record_transition(event.time, event.type, event.thread, event.thread->previous_state, event.thread->current_state);
+            }
+        } else {
+            this->logger.print_state_transition(event, event.thread->previous_state, event.thread->current_state);
+        }
+        if (this->trace != nullptr) {
+            this->trace->record_transition(event.time, event.type, event.thread, event.thread->previous_state, event.thread->current_state);
+        }
+        if (this->chrome_trace != nullptr) {
+            this->chrome_trace->record_transition(event.time, event.thread, event.thread->previous_state);
+        }
+    }
+    this->system_stats.total_time = event.time;
+
+    if (event.type == THREAD_COMPLETED && this->flags.retire) {
+        this->retire_thread(event.thread);
+    }
+
+    if (!this->flags.checkpoint_file.empty() && this->run_info.events_processed % CHECKPOINT_CHECK_EVENTS == 0
+            && std::chrono::steady_clock::now() >= this->next_checkpoint) {
+        this->save_checkpoint(this->flags.checkpoint_file);
+        this->next_checkpoint = seconds_from_now(this->flags.checkpoint_interval);
+    }
+    return true;
+}
+
+bool Simulation::next_event(Event& event) {
+    const std::vector<uint32_t>& arrivals = this->workload->arrival_order;
+    // Whether there is a queued event to process before the horizon.
+    bool queued = !this->events.empty() && this->events.top().time <= this->horizon;
+
+    if (this->open_arrivals != nullptr) {
+        SimTime arrival_time = this->open_thread.arrival_time;
+
+        if (arrival_time <= this->horizon && (!queued || arrival_time <= this->events.top().time)) {
+            Thread* thread = this->allocate_thread(this->open_thread, this->open_bursts.data(), (uint32_t) this->next_arrival);
+            event = Event(THREAD_ARRIVED, arrival_time, this->next_arrival, thread);
+            this->next_arrival++;
+            this->next_open_arrival();
+            return true;
+        }
+    } else if (this->next_arrival < arrivals.size()) {
+        const ThreadSpec& spec = this->workload->threads[arrivals[this->next_arrival]];
+        SimTime arrival_time = spec.arrival_time;
+
+        if (arrival_time <= this->horizon && (!queued || arrival_time <= this->events.top().time)) {
+            Thread* thread = this->create_thread(arrivals[this->next_arrival]);
+            event = Event(THREAD_ARRIVED, arrival_time, this->next_arrival, thread);
+            this->next_arrival++;
+            return true;
+        }
+    }
+
+    if (!queued) {
+        return false;
+    }
+
+    event = this->events.top();
+    this->events.pop();
+    return true;
+}
+
+bool Simulation::work_remaining() const {
+    return !this->events.empty() || this->open_arrivals != nullptr
+        || this->next_arrival < this->workload->arrival_order.size();
+}
 
+void Simulation::stop(const std::string& reason, SimTime stop_time) {
+    this->run_info.stop_reason = reason;
+    this->system_stats.total_time = stop_time;
+
+    // CPU, IO and dispatch time are accounted for when they are scheduled, so take
+    // back whatever was scheduled past the stop. The run cannot go on after this.
+    for (; !this->events.empty(); this->events.pop()) {
+        const Event& event = this->events.top();
+        SimTime overshoot = std::max<SimTime>(event.time - stop_time, 0);
+
+        switch (event.type) {
             case CPU_BURST_COMPLETED:
-                this->handle_cpu_burst_completed(event);
+            case THREAD_COMPLETED:
+            case THREAD_PREEMPTED:
+                this->system_stats.service_time -= overshoot;
                 break;
 
             case IO_BURST_COMPLETED:
-                this->handle_io_burst_completed(event);
-                break;
-            case THREAD_COMPLETED:
-                this->handle_thread_completed(event);
+                this->system_stats.io_time -= overshoot;
                 break;
 
-            case THREAD_PREEMPTED:
-                this->handle_thread_preempted(event);
+            case THREAD_DISPATCH_COMPLETED:
+            case PROCESS_DISPATCH_COMPLETED:
+                this->system_stats.dispatch_time -= overshoot;
                 break;
 
-            case DISPATCHER_INVOKED:
-                this->handle_dispatcher_invoked(event);
+            default:
                 break;
         }
+    }
+}
 
-        // If this event triggered a state change, print it out.
-        if (event->thread && event->thread->current_state != event->thread->previous_state) {
-            this->logger.print_state_transition(event, event->thread->previous_state, event->thread->current_state);
+void Simulation::next_open_arrival() {
+    this->open_bursts.clear();
+    if (!this->open_arrivals->next(this->open_thread, this->open_bursts)) {
+        this->open_arrivals.reset();
+    }
+}
+
+Thread* Simulation::allocate_thread(const ThreadSpec& spec, const Burst* bursts, uint32_t handle) {
+    void* memory = this->thread_pool.allocate(sizeof(Thread), alignof(Thread));
+    Thread* thread = new (memory) Thread(spec.arrival_time, spec.thread_id, spec.process_id, spec.priority);
+    thread->handle = handle;
+
+    // Each run gets its own copy of the bursts, since preemption shortens them.
+    thread->num_bursts = spec.num_bursts;
+    if (spec.num_bursts != 0) {
+        void* bursts_memory = this->burst_resource(spec.num_bursts)->allocate(sizeof(Burst) * spec.num_bursts, alignof(Burst));
+        thread->bursts = static_cast<Burst*>(bursts_memory);
+        std::uninitialized_copy_n(bursts, spec.num_bursts, thread->bursts);
+    }
+    return thread;
+}
+
+std::pmr::memory_resource* Simulation::burst_resource(size_t num_bursts) {
+    if (sizeof(Burst) * num_bursts <= this->thread_pool.options().largest_required_pool_block) {
+        return &this->thread_pool;
+    }
+    return &this->large_bursts;
+}
+
+Thread* Simulation::create_thread(size_t spec_index) {
+    const ThreadSpec& spec = this->workload->threads[spec_index];
+    Thread* thread = this->allocate_thread(spec, this->workload->bursts.data() + spec.first_burst, (uint32_t) spec_index);
+
+    if (!this->flags.retire) {
+        const ProcessSpec& process_spec = this->workload->processes[spec.process_index];
+        this->process_table[spec.process_index]->threads[spec_index - process_spec.first_thread] = thread;
+    }
+
+    return thread;
+}
+
+void Simulation::retire_thread(Thread* thread) {
+    if (this->async_logger != nullptr) {
+        if (this->logger.per_thread) {
+            this->async_logger->record_summary(thread->end_time, thread);
         }
-        this->system_stats.total_time = event->time;
-        event.reset();
+    } else {
+        this->logger.print_thread_summary(thread);
     }
-    // We are done!
 
-    std::cout << "SIMULATION COMPLETED!\n\n";
+    if (this->retired_thread != nullptr) {
+        Thread* old = this->retired_thread;
+        if (old->num_bursts != 0) {
+            this->burst_resource(old->num_bursts)->deallocate(old->bursts, sizeof(Burst) * old->num_bursts, alignof(Burst));
+        }
+        this->thread_pool.deallocate(old, sizeof(Thread), alignof(Thread));
+    }
+    this->retired_thread = thread;
+}
+
+void Simulation::report() {
+    if (this->flags.format == "json") {
+        this->logger.print_json_report(this->system_stats, this->run_info,
+            this->flags.arrival_rate > 0 ? &this->steady_state : nullptr);
+        return;
+    }
+
+    const std::string& reason = this->run_info.stop_reason;
+    if (reason.empty() || reason == "duration") {
+        *this->output << "SIMULATION COMPLETED!\n\n";
+    } else {
+        *this->output << "SIMULATION STOPPED EARLY (" << reason << ")!\n\n";
+    }
 
     for (auto entry: this->processes) {
         this->logger.print_per_thread_metrics(entry.second);
     }
 
-    logger.print_simulation_metrics(this->calculate_statistics());
+    logger.print_simulation_metrics(this->system_stats);
+
+    if (this->flags.arrival_rate > 0) {
+        this->logger.print_steady_state(this->steady_state, this->offered_load);
+    }
+
+    if (this->flags.profile) {
+        if (PROFILING_ENABLED) {
+            this->logger.print_profile(this->profiler);
+        } else {
+            *this->output << "Profiling is not compiled in: rebuild with `make clean && make PROFILE=1`.\n";
+        }
+    }
 }
 
 //==============================================================================
 // Event-handling methods
 //==============================================================================
 
-void Simulation::handle_thread_arrived(const std::shared_ptr<Event> event) {
-    event->thread->arrival_time = event->time; //set the thread's arrival time
-    event->thread->set_ready(event->time); //set thread to ready
-    scheduler->add_to_ready_queue(event->thread); //add thread to the ready queue
+void Simulation::handle_thread_arrived(const Event& event) {
+    event.thread->arrival_time = event.time; //set the thread's arrival time
+    event.thread->set_ready(event.time); //set thread to ready
+    scheduler->add_to_ready_queue(event.thread); //add thread to the ready queue
+    PROFILE(this->profiler.scheduler_adds++;)
     //check if cpu is idle
     if(active_thread == nullptr){
         //create new dispatcher invoked event
         event_num++;
-        std::shared_ptr<Event> e = std::make_shared<Event>(DISPATCHER_INVOKED, event->time, event_num, nullptr, nullptr);
+        Event e(DISPATCHER_INVOKED, event.time, event_num, nullptr);
         //add new event to event queue
         events.push(e);
     }
     return;
 }
 
-void Simulation::dispatch_completed_helper(const std::shared_ptr<Event> event, const std::shared_ptr<Burst> b){
+void Simulation::dispatch_completed_helper(const Event& event, const Burst* b){
+    //this dispatch runs the burst to completion, so its wait is final
+    this->system_stats.burst_wait_histograms[event.thread->priority].record(event.thread->burst_wait_time);
+    event.thread->burst_wait_time = 0;
+
     event_num++;
-    if(event->thread->bursts.size() == 0){
+    if(event.thread->bursts_remaining() == 0){
         //no more bursts for this thread, create THREAD_FINISHED event
-        std::shared_ptr<Event> e = std::make_shared<Event>(THREAD_COMPLETED, event->time + b->length, event_num, event->thread, event->scheduling_decision);
+        Event e(THREAD_COMPLETED, event.time + b->length, event_num, event.thread, event.scheduling_decision);
         events.push(e);
     }
     else{
         //still more bursts, create cpu burst completed event
-        std::shared_ptr<Event> e = std::make_shared<Event>(CPU_BURST_COMPLETED, event->time + b->length, event_num, event->thread, event->scheduling_decision);
+        Event e(CPU_BURST_COMPLETED, event.time + b->length, event_num, event.thread, event.scheduling_decision);
         events.push(e);
     }
     //update time spent on CPU
-    event->thread->service_time += b->length;
+    event.thread->service_time += b->length;
+    this->system_stats.service_time += b->length;
 }
 
-void Simulation::handle_dispatch_completed(const std::shared_ptr<Event> event) {
+void Simulation::handle_dispatch_completed(const Event& event) {
     //thread transitions from READY to RUNNING
-    if(event->thread->previous_state == NEW){ //first time thread starts running, set start time
-        event->thread->start_time = event->time;
-    }
-    event->thread->set_running(event->time);
-    //check if using a preemptive algorithm
-    if(flags.scheduler == "RR"){ //is a preemptive algo
-        std::shared_ptr<Burst> current_burst = event->thread->get_next_burst(CPU);
-        if(current_burst->length - event->scheduling_decision->time_slice <= 0){//can finish the burst
-            event->thread->pop_next_burst(CPU);
+    if(event.thread->previous_state == NEW){ //first time thread starts running, set start time
+        event.thread->start_time = event.time;
+    }
+    //the burst has been waiting since the thread became ready
+    event.thread->burst_wait_time += event.time - event.thread->state_change_time;
+    event.thread->set_running(event.time);
+    //check if the scheduler gave the thread a time slice (i.e. is a preemptive algorithm)
+    if(event.scheduling_decision.time_slice != -1){ //is a preemptive algo
+        Burst* current_burst = event.thread->get_next_burst(CPU);
+        if(current_burst->length - event.scheduling_decision.time_slice <= 0){//can finish the burst
+            event.thread->pop_next_burst(CPU);
             dispatch_completed_helper(event, current_burst);
             return;
         }
         else{//cant finish the burst, so preemp it
             event_num++;
-            std::shared_ptr<Event> e = std::make_shared<Event>(THREAD_PREEMPTED, event->time + event->scheduling_decision->time_slice,
-                event_num, event->thread, event->scheduling_decision);
+            Event e(THREAD_PREEMPTED, event.time + event.scheduling_decision.time_slice,
+                event_num, event.thread, event.scheduling_decision);
             events.push(e);
             //update time on CPU it was able to spend
-            event->thread->service_time += event->scheduling_decision->time_slice;
+            event.thread->service_time += event.scheduling_decision.time_slice;
+            this->system_stats.service_time += event.scheduling_decision.time_slice;
             return;
         }
     }
     else{ //non-preemptive, so complete a cpu burst
-        std::shared_ptr<Burst> b = event->thread->get_next_burst(CPU);
-        event->thread->pop_next_burst(CPU);
+        Burst* b = event.thread->get_next_burst(CPU);
+        event.thread->pop_next_burst(CPU);
         dispatch_completed_helper(event, b);
         return;
     }
 }
 
-void Simulation::handle_cpu_burst_completed(const std::shared_ptr<Event> event) {
+void Simulation::handle_cpu_burst_completed(const Event& event) {
     //transition thread from RUNNING to BLOCKED 
-    event->thread->set_blocked(event->time);
+    event.thread->set_blocked(event.time);
     prev_thread = active_thread;
     active_thread = nullptr; //thread is blocked, so is not active
     //create new IO burst event and update time
     event_num++;
-    std::shared_ptr<Burst> b = event->thread->get_next_burst(IO);
-    event->thread->pop_next_burst(IO);
+    Burst* b = event.thread->get_next_burst(IO);
+    event.thread->pop_next_burst(IO);
     if(b != nullptr){//got next io burst
         //also make new dispatcher invoked event, since cpu burst just completed
-        std::shared_ptr<Event> di = std::make_shared<Event>(DISPATCHER_INVOKED, event->time, event_num, nullptr, nullptr);
+        Event di(DISPATCHER_INVOKED, event.time, event_num, nullptr);
         events.push(di);
         event_num++;
-        std::shared_ptr<Event> e = std::make_shared<Event>(IO_BURST_COMPLETED, event->time + b->length, event_num, event->thread, event->scheduling_decision);
+        Event e(IO_BURST_COMPLETED, event.time + b->length, event_num, event.thread, event.scheduling_decision);
         events.push(e);
         //update time spent on IO
-        event->thread->io_time += b->length;
+        event.thread->io_time += b->length;
+        this->system_stats.io_time += b->length;
     }
     else{//should techinally be thread completed if this occurs
         return;
     }
 }
 
-void Simulation::handle_io_burst_completed(const std::shared_ptr<Event> event) {
+void Simulation::handle_io_burst_completed(const Event& event) {
     //thread transitions from blocked to ready
-    event->thread->set_ready(event->time);
+    event.thread->set_ready(event.time);
     //put thread back in ready queue
-    scheduler->add_to_ready_queue(event->thread);
+    scheduler->add_to_ready_queue(event.thread);
+    PROFILE(this->profiler.scheduler_adds++;)
 
     if(active_thread == nullptr){
         //create new dispatcher invoked event
         event_num++;
-        std::shared_ptr<Event> e = std::make_shared<Event>(DISPATCHER_INVOKED, event->time, event_num, nullptr, nullptr);
+        Event e(DISPATCHER_INVOKED, event.time, event_num, nullptr);
         events.push(e);
     }
     return;
 }
 
-void Simulation::handle_thread_completed(const std::shared_ptr<Event> event) {
+void Simulation::handle_thread_completed(const Event& event) {
     //transition from RUNNING TO EXIT
-    event->thread->set_finished(event->time);
+    event.thread->set_finished(event.time);
     //update thread end time
-    event->thread->end_time = event->time;
+    event.thread->end_time = event.time;
+    record_thread_statistics(event.thread);
+    this->completed_threads++;
+    if (this->convergence != nullptr && this->convergence->add(event.thread->turnaround_time())) {
+        this->converged = true;
+    }
+    if (this->flags.arrival_rate > 0) {
+        // Nothing is running or being dispatched as a thread exits, so the busy time is exact.
+        this->steady_recorder.record(event.time, event.thread->response_time(), event.thread->turnaround_time(),
+            this->system_stats.service_time + this->system_stats.dispatch_time);
+    }
+    if (this->exporter != nullptr) {
+        this->exporter->write(event.thread);
+    }
 
     prev_thread = active_thread;
     active_thread = nullptr;
@@ -207,55 +658,79 @@ void Simulation::handle_thread_completed(const std::shared_ptr<Event> event) {
     //create new dispatcher invoked event
     if(active_thread == nullptr){
         event_num++;
-        std::shared_ptr<Event> e = std::make_shared<Event>(DISPATCHER_INVOKED, event->time, event_num, nullptr, nullptr);
+        Event e(DISPATCHER_INVOKED, event.time, event_num, nullptr);
         events.push(e);
     }
 }
 
-void Simulation::handle_thread_preempted(const std::shared_ptr<Event> event) {
+void Simulation::handle_thread_preempted(const Event& event) {
     //set status of current thread from running to ready
-    event->thread->set_ready(event->time);
+    event.thread->set_ready(event.time);
     //update remaining burst time of thread
-    std::shared_ptr<Burst> current_burst = event->thread->get_next_burst(CPU);
-    current_burst->update_time(event->scheduling_decision->time_slice);
+    Burst* current_burst = event.thread->get_next_burst(CPU);
+    current_burst->update_time(event.scheduling_decision.time_slice);
     //save current status of thread and add to back of thread queue
-    scheduler->add_to_ready_queue(event->thread);
+    scheduler->add_to_ready_queue(event.thread);
+    PROFILE(this->profiler.scheduler_adds++;)
     //create new DISPATCHER_INVOKED event
     event_num++;
-    std::shared_ptr<Event> e = std::make_shared<Event>(DISPATCHER_INVOKED, event->time, event_num, nullptr, nullptr);
+    Event e(DISPATCHER_INVOKED, event.time, event_num, nullptr);
     events.push(e);
 }
 
-void Simulation::handle_dispatcher_invoked(const std::shared_ptr<Event> event) {
+void Simulation::handle_dispatcher_invoked(const Event& event) {
     //check if cpu is idle
     if(active_thread != nullptr){ //cpu is not idle
         //set previous thread to active thread
         prev_thread = active_thread;
     }
     //try to get the next thread from the scheduling algo
-    std::shared_ptr<SchedulingDecision> sd = scheduler->get_next_thread();
+    PROFILE(uint64_t pick_start = Profiler::now();)
+    SchedulingDecision sd = scheduler->get_next_thread();
+    PROFILE(this->profiler.scheduler_picks++;
+            this->profiler.scheduler_pick_ticks += Profiler::now() - pick_start;)
 
     //check if we got a thread
-    if(sd->thread != nullptr){
-        this->logger.print_verbose(event, sd->thread, sd->explanation);
+    if(sd.thread != nullptr){
+        //only build the explanation when it is going to be printed
+        if(this->logger.wants_verbose(event, sd.thread)){
+            if(this->async_logger != nullptr){
+                this->async_logger->record_decision(event.time, sd);
+            }
+            else{
+                this->logger.print_verbose(event, sd.thread, sd.explanation());
+            }
+        }
+        if(this->trace != nullptr){
+            this->trace->record_decision(event.time, sd);
+        }
+
+        //the thread has been in the ready queue since its last state change
+        this->system_stats.ready_wait_histograms[sd.thread->priority].record(event.time - sd.thread->state_change_time);
 
         //set the active cpu thread to the new thread
-        active_thread = sd->thread;
+        active_thread = sd.thread;
         event_num++;
         //check if the new thread is from the same process as previous thread
         if(prev_thread != nullptr && active_thread->process_id == prev_thread->process_id){ //same parent process
             //next event will be a thread dispatch
-            std::shared_ptr<Event> e = std::make_shared<Event>(THREAD_DISPATCH_COMPLETED, event->time + thread_switch_overhead,
+            Event e(THREAD_DISPATCH_COMPLETED, event.time + thread_switch_overhead,
                  event_num, active_thread, sd);
             events.push(e);
             this->system_stats.dispatch_time += thread_switch_overhead;
+            if(this->chrome_trace != nullptr){
+                this->chrome_trace->record_dispatch(event.time, thread_switch_overhead, active_thread, false);
+            }
         }
         else{
             //next event will be a process dispatch
-            std::shared_ptr<Event> e = std::make_shared<Event>(PROCESS_DISPATCH_COMPLETED, event->time + process_switch_overhead,
+            Event e(PROCESS_DISPATCH_COMPLETED, event.time + process_switch_overhead,
                  event_num, active_thread, sd);
             events.push(e);
             this->system_stats.dispatch_time += process_switch_overhead;
+            if(this->chrome_trace != nullptr){
+                this->chrome_trace->record_dispatch(event.time, process_switch_overhead, active_thread, true);
+            }
         }
         return;
     }
@@ -268,104 +743,525 @@ void Simulation::handle_dispatcher_invoked(const std::shared_ptr<Event> event) {
 
 
 //==============================================================================
-// Utility methods
+// Checkpoints
 //==============================================================================
 
-SystemStats Simulation::calculate_statistics() {
-    //Implement functionality for calculating the simulation statistics
-    //loop over every process, then loop over every thread of each process and get stats that were stored in each thread
-    std::vector<int> total_repsonse_times = {0, 0, 0, 0};
-    std::vector<int> total_turnaround_times = {0, 0, 0, 0};
-    for(auto it = processes.begin(); it != processes.end(); it++){
-        std::shared_ptr<Process> p = it->second; //get process
-        for(int i = 0; i < p->threads.size(); i++){ //go over each thread in process
-            std::shared_ptr<Thread> thread = p->threads[i];
-            this->system_stats.io_time += thread->io_time; //update io time
-            this->system_stats.service_time += thread->service_time; //update CPU time
-            this->system_stats.total_cpu_time = this->system_stats.service_time; //service time same as total cpu time?
-            if(this->system_stats.total_time < thread->end_time){
-                this->system_stats.total_time = thread->end_time;
-            }
-            //update thread type counts
-            this->system_stats.thread_counts[thread->priority]++;
+/*
+    ThreadRecord, EventRecord:
+        How threads and events are saved. Threads get new addresses on restore, so
+        they are referred to by their handle (-1 for no thread). Of a workload thread's
+        bursts only the next one is saved, since it is the only one a run changes;
+        open-system threads are not in the workload, so all their bursts follow their
+        record.
+*/
+struct ThreadRecord {
+    int64_t handle;
+    SimTime arrival_time;
+    SimTime start_time;
+    SimTime end_time;
+    SimTime service_time;
+    SimTime io_time;
+    SimTime burst_wait_time;
+    SimTime state_change_time;
+    SimTime next_burst_length;
+    uint64_t next_burst;
+    uint64_t num_bursts;
+    int32_t thread_id;
+    int32_t process_id;
+    int32_t priority;
+    int32_t current_state;
+    int32_t previous_state;
+    int32_t unused;
+};
+
+struct EventRecord {
+    SimTime time;
+    uint64_t event_num;
+    int64_t thread;
+    int64_t decision_thread;
+    int32_t type;
+    int32_t time_slice;
+    int32_t reason;
+    int32_t queue;
+    uint32_t queue_sizes[4];
+};
+
+// Thread records are gathered and written this many at a time.
+static const size_t THREAD_BATCH = 1 << 16;
+
+static std::vector<uint32_t> checkpoint_layout() {
+    return {sizeof(SimTime), sizeof(ThreadRecord), sizeof(EventRecord), sizeof(SystemStats),
+            sizeof(ConvergenceMonitor), sizeof(SteadyStateBatch), sizeof(ThreadSpec),
+            sizeof(ProcessSpec), sizeof(Burst)};
+}
+
+static int64_t handle_of(const Thread* thread) {
+    return thread == nullptr ? -1 : (int64_t) thread->handle;
+}
+
+// The events in the queue, in the order of its heap.
+static const std::pmr::vector<Event>& queued_events(const EventQueue& queue) {
+    struct Access : EventQueue {
+        static const std::pmr::vector<Event>& of(const EventQueue& queue) {
+            return queue.*(&Access::c);
+        }
+    };
+    return Access::of(queue);
+}
+
+static ThreadRecord thread_record(const Thread* thread) {
+    ThreadRecord record = {};
+    record.handle = thread->handle;
+    record.arrival_time = thread->arrival_time;
+    record.start_time = thread->start_time;
+    record.end_time = thread->end_time;
+    record.service_time = thread->service_time;
+    record.io_time = thread->io_time;
+    record.burst_wait_time = thread->burst_wait_time;
+    record.state_change_time = thread->state_change_time;
+    record.next_burst_length = thread->next_burst < thread->num_bursts ? thread->bursts[thread->next_burst].length : 0;
+    record.next_burst = thread->next_burst;
+    record.num_bursts = thread->num_bursts;
+    record.thread_id = thread->thread_id;
+    record.process_id = thread->process_id;
+    record.priority = thread->priority;
+    record.current_state = thread->current_state;
+    record.previous_state = thread->previous_state;
+    return record;
+}
+
+static void apply_thread_record(Thread* thread, const ThreadRecord& record) {
+    thread->start_time = record.start_time;
+    thread->end_time = record.end_time;
+    thread->service_time = record.service_time;
+    thread->io_time = record.io_time;
+    thread->burst_wait_time = record.burst_wait_time;
+    thread->state_change_time = record.state_change_time;
+    thread->current_state = (ThreadState) record.current_state;
+    thread->previous_state = (ThreadState) record.previous_state;
+    thread->next_burst = record.next_burst;
+    if (thread->next_burst < thread->num_bursts) {
+        thread->bursts[thread->next_burst].length = record.next_burst_length;
+    }
+}
+
+std::string Simulation::checkpoint_config() const {
+    std::ostringstream config;
+    config << "file=" << this->flags.filename << " generate=" << this->flags.generate;
+    // The runs branching from a shared prefix each continue with their own scheduler.
+    if (this->flags.branch_at == 0) {
+        config << " algorithm=" << this->flags.scheduler << " time_slice=" << this->flags.time_slice;
+    }
+    config << " retire=" << this->flags.retire
+           << " threads=" << this->workload->threads.size() << " bursts=" << this->workload->bursts.size()
+           << " overheads=" << this->thread_switch_overhead << "," << this->process_switch_overhead
+           << std::hexfloat << " arrival_rate=" << this->flags.arrival_rate << " converge=" << this->flags.converge
+           << " batches=" << this->flags.batches;
+    return config.str();
+}
 
-            //add to total repsonse times and turnaround times
-            total_repsonse_times[thread->priority] += thread->response_time();
-            total_turnaround_times[thread->priority] += thread->turnaround_time();
+void Simulation::save_checkpoint(const std::string& filename) const {
+    CheckpointWriter writer(filename, checkpoint_layout());
+    writer.write_string(this->checkpoint_config());
+    writer.write_string(this->flags.scheduler);
+
+    writer.write<uint64_t>(this->next_arrival);
+    writer.write(this->event_num);
+    writer.write(this->completed_threads);
+    writer.write(this->converged);
+    writer.write(this->run_info.events_processed);
+    writer.write(this->system_stats);
+    writer.write(this->convergence != nullptr);
+    if (this->convergence != nullptr) {
+        writer.write(*this->convergence);
+    }
+    this->steady_recorder.save(writer);
+
+    writer.write(this->open_arrivals != nullptr);
+    if (this->open_arrivals != nullptr) {
+        this->open_arrivals->save(writer);
+        writer.write(this->open_thread);
+        writer.write_vector(this->open_bursts);
+    }
+
+    const std::pmr::vector<Event>& queued = queued_events(this->events);
+    std::vector<Thread*> ready;
+    this->scheduler->ready_threads(ready);
+
+    // Without retirement every thread that has arrived is filed under its process.
+    // With it, the live threads are exactly the ones something still refers to.
+    std::vector<const Thread*> threads;
+    if (this->flags.retire) {
+        for (const Event& event : queued) {
+            threads.push_back(event.thread);
+            threads.push_back(event.scheduling_decision.thread);
+        }
+        threads.insert(threads.end(), ready.begin(), ready.end());
+        threads.push_back(this->active_thread);
+        threads.push_back(this->prev_thread);
+        threads.push_back(this->retired_thread);
+        threads.erase(std::remove(threads.begin(), threads.end(), nullptr), threads.end());
+        std::sort(threads.begin(), threads.end());
+        threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+    } else {
+        for (const Process* process : this->process_table) {
+            for (const Thread* thread : process->threads) {
+                if (thread != nullptr) {
+                    threads.push_back(thread);
+                }
+            }
         }
     }
-    for(int i = 0; i < 4; i++){
-        if(this->system_stats.thread_counts[i] != 0){
-            this->system_stats.avg_thread_response_times[i] = (double)total_repsonse_times[i] / this->system_stats.thread_counts[i];
-            this->system_stats.avg_thread_turnaround_times[i] = (double)total_turnaround_times[i] / this->system_stats.thread_counts[i];
+
+    writer.write<uint64_t>(threads.size());
+    if (this->flags.arrival_rate > 0) {
+        for (const Thread* thread : threads) {
+            writer.write(thread_record(thread));
+            writer.write_array(thread->bursts, thread->num_bursts);
         }
+    } else {
+        std::vector<ThreadRecord> batch;
+        batch.reserve(std::min(threads.size(), THREAD_BATCH));
+        for (const Thread* thread : threads) {
+            batch.push_back(thread_record(thread));
+            if (batch.size() == THREAD_BATCH) {
+                writer.write_array(batch.data(), batch.size());
+                batch.clear();
+            }
+        }
+        writer.write_array(batch.data(), batch.size());
     }
-    this->system_stats.total_idle_time = this->system_stats.total_time - this->system_stats.service_time - this->system_stats.dispatch_time;
-    this->system_stats.cpu_utilization = ((double)(this->system_stats.dispatch_time + this->system_stats.service_time) / this->system_stats.total_time) * 100;
-    this->system_stats.cpu_efficiency = ((double)this->system_stats.service_time / this->system_stats.total_time) * 100;
-    return this->system_stats;
+
+    writer.write(handle_of(this->active_thread));
+    writer.write(handle_of(this->prev_thread));
+    writer.write(handle_of(this->retired_thread));
+
+    std::vector<EventRecord> event_records;
+    event_records.reserve(queued.size());
+    for (const Event& event : queued) {
+        const SchedulingDecision& sd = event.scheduling_decision;
+        EventRecord record = {};
+        record.time = event.time;
+        record.event_num = event.event_num;
+        record.thread = handle_of(event.thread);
+        record.decision_thread = handle_of(sd.thread);
+        record.type = event.type;
+        record.time_slice = sd.time_slice;
+        record.reason = sd.reason;
+        record.queue = sd.queue;
+        std::copy(sd.queue_sizes, sd.queue_sizes + 4, record.queue_sizes);
+        event_records.push_back(record);
+    }
+    writer.write_vector(event_records);
+
+    std::vector<int64_t> ready_handles;
+    ready_handles.reserve(ready.size());
+    for (const Thread* thread : ready) {
+        ready_handles.push_back(thread->handle);
+    }
+    writer.write_vector(ready_handles);
+
+    writer.commit();
 }
 
-void Simulation::add_event(std::shared_ptr<Event> event) {
-    if (event != nullptr) {
-        this->events.push(event);
+void Simulation::restore_checkpoint(const std::string& filename) {
+    CheckpointReader reader(filename, checkpoint_layout());
+    if (reader.read_string() != this->checkpoint_config()) {
+        reader.fail("it was made with a different workload or options");
+    }
+    std::string saved_scheduler = reader.read_string();
+
+    this->next_arrival = reader.read<uint64_t>();
+    this->event_num = reader.read<uint64_t>();
+    this->completed_threads = reader.read<uint64_t>();
+    this->converged = reader.read<bool>();
+    this->run_info.events_processed = reader.read<uint64_t>();
+    this->system_stats = reader.read<SystemStats>();
+    if (reader.read<bool>()) {
+        reader.read_array(this->convergence.get(), 1);
+    }
+    this->steady_recorder.restore(reader);
+
+    if (reader.read<bool>()) {
+        if (this->open_arrivals == nullptr) {
+            reader.fail("its arrivals go past this run's duration");
+        }
+        this->open_arrivals->restore(reader);
+        this->open_thread = reader.read<ThreadSpec>();
+        this->open_bursts.assign(reader.read<uint64_t>(), Burst(CPU, 0));
+        reader.read_array(this->open_bursts.data(), this->open_bursts.size());
+    } else {
+        this->open_arrivals.reset();
+    }
+
+    uint64_t num_threads = reader.read<uint64_t>();
+    std::unordered_map<int64_t, Thread*> threads;
+    threads.reserve(num_threads);
+
+    auto restore_thread = [&](const ThreadRecord& record, const Burst* bursts) {
+        Thread* thread;
+        if (bursts != nullptr) {
+            ThreadSpec spec;
+            spec.thread_id = record.thread_id;
+            spec.process_id = record.process_id;
+            spec.priority = (ProcessPriority) record.priority;
+            spec.arrival_time = record.arrival_time;
+            spec.num_bursts = record.num_bursts;
+            thread = this->allocate_thread(spec, bursts, (uint32_t) record.handle);
+        } else {
+            if (record.handle < 0 || (uint64_t) record.handle >= this->workload->threads.size()) {
+                reader.fail("it refers to a thread that is not in the workload");
+            }
+            thread = this->create_thread(record.handle);
+        }
+        if (record.next_burst > thread->num_bursts || !threads.emplace(record.handle, thread).second) {
+            reader.fail("its threads are inconsistent");
+        }
+        apply_thread_record(thread, record);
+    };
+
+    if (this->flags.arrival_rate > 0) {
+        std::vector<Burst> bursts;
+        for (uint64_t i = 0; i < num_threads; ++i) {
+            ThreadRecord record = reader.read<ThreadRecord>();
+            bursts.assign(record.num_bursts, Burst(CPU, 0));
+            reader.read_array(bursts.data(), bursts.size());
+            restore_thread(record, bursts.data());
+        }
+    } else {
+        std::vector<ThreadRecord> batch(std::min<uint64_t>(num_threads, THREAD_BATCH));
+        for (uint64_t done = 0; done < num_threads; done += batch.size()) {
+            batch.resize(std::min<uint64_t>(num_threads - done, THREAD_BATCH));
+            reader.read_array(batch.data(), batch.size());
+            for (const ThreadRecord& record : batch) {
+                restore_thread(record, nullptr);
+            }
+        }
+    }
+
+    auto thread_at = [&](int64_t handle) -> Thread* {
+        if (handle == -1) {
+            return nullptr;
+        }
+        auto found = threads.find(handle);
+        if (found == threads.end()) {
+            reader.fail("it refers to a thread it does not hold");
+        }
+        return found->second;
+    };
+
+    this->active_thread = thread_at(reader.read<int64_t>());
+    this->prev_thread = thread_at(reader.read<int64_t>());
+    this->retired_thread = thread_at(reader.read<int64_t>());
+
+    std::vector<EventRecord> event_records;
+    reader.read_vector(event_records);
+    std::pmr::vector<Event> queued(&this->arena);
+    queued.reserve(event_records.size());
+    for (const EventRecord& record : event_records) {
+        SchedulingDecision sd;
+        sd.thread = thread_at(record.decision_thread);
+        sd.time_slice = record.time_slice;
+        sd.reason = (DecisionReason) record.reason;
+        sd.queue = record.queue;
+        std::copy(record.queue_sizes, record.queue_sizes + 4, sd.queue_sizes);
+        queued.emplace_back((EventType) record.type, record.time, record.event_num, thread_at(record.thread), sd);
+    }
+    if (this->flags.branch_at != 0) {
+        this->apply_branch_time_slice(queued);
+    }
+    this->events = EventQueue(EventComparator(), std::move(queued));
+
+    std::vector<int64_t> ready_handles;
+    reader.read_vector(ready_handles);
+    std::vector<Thread*> ready;
+    ready.reserve(ready_handles.size());
+    for (int64_t handle : ready_handles) {
+        Thread* thread = thread_at(handle);
+        if (thread == nullptr) {
+            reader.fail("its ready queue is inconsistent");
+        }
+        ready.push_back(thread);
+    }
+    // The saved order is only meaningful to the scheduler that saved it (a priority
+    // scheduler's is grouped by queue). Another one gets the threads in the order they
+    // became ready, as if it had been scheduling all along.
+    if (saved_scheduler != this->flags.scheduler) {
+        std::stable_sort(ready.begin(), ready.end(), [](const Thread* a, const Thread* b) {
+            return std::tie(a->state_change_time, a->process_id, a->thread_id)
+                 < std::tie(b->state_change_time, b->process_id, b->thread_id);
+        });
+    }
+    for (Thread* thread : ready) {
+        this->scheduler->add_to_ready_queue(thread);
     }
 }
 
-void Simulation::read_file(const std::string filename) {
-    std::ifstream input_file(filename.c_str());
+void Simulation::apply_branch_time_slice(std::pmr::vector<Event>& queued) {
+    int time_slice = this->scheduler->time_slice;
+    SimTime branch_at = this->flags.branch_at;
 
-    if (!input_file) {
-        std::cerr << "Unable to open simulation file: " << filename << std::endl;
-        throw(std::logic_error("Bad file."));
+    for (Event& event : queued) {
+        switch (event.type) {
+            case THREAD_DISPATCH_COMPLETED:
+            case PROCESS_DISPATCH_COMPLETED:
+                // Nothing has been decided from the slice until the dispatch completes.
+                event.scheduling_decision.time_slice = time_slice;
+                break;
+
+            case CPU_BURST_COMPLETED:
+            case THREAD_COMPLETED:
+            case THREAD_PREEMPTED: {
+                // The running thread, dispatched at start with length left of its burst.
+                Thread* thread = event.thread;
+                bool preempted = event.type == THREAD_PREEMPTED;
+                if (!preempted) {
+                    thread->next_burst--;
+                }
+                SimTime length = thread->get_next_burst(CPU)->length;
+                SimTime ran = preempted ? event.scheduling_decision.time_slice : length;
+                SimTime start = event.time - ran;
+
+                SimTime runs = length;
+                if (time_slice != -1 && length > time_slice) {
+                    // It cannot be stopped before the branch point if it has run past its new slice.
+                    runs = std::max<SimTime>(time_slice, branch_at - start);
+                }
+
+                if (runs < length) {
+                    // If the prefix was to finish the burst, its wait was recorded as final
+                    // at the dispatch: the wait left until it finishes is recorded apart.
+                    event.type = THREAD_PREEMPTED;
+                } else {
+                    thread->pop_next_burst(CPU);
+                    event.type = thread->bursts_remaining() == 0 ? THREAD_COMPLETED : CPU_BURST_COMPLETED;
+                    if (preempted) {
+                        // As in dispatch_completed_helper: this run finishes the burst.
+                        this->system_stats.burst_wait_histograms[thread->priority].record(thread->burst_wait_time);
+                        thread->burst_wait_time = 0;
+                    }
+                }
+                event.time = start + runs;
+                event.scheduling_decision.time_slice = runs < length ? (int) runs : time_slice;
+                thread->service_time += runs - ran;
+                this->system_stats.service_time += runs - ran;
+                break;
+            }
+
+            default:
+                break;
+        }
     }
+}
 
-    int num_processes;
+//==============================================================================
+// Utility methods
+//==============================================================================
 
-    input_file >> num_processes >> this->thread_switch_overhead >> this->process_switch_overhead;
+void Simulation::record_thread_statistics(const Thread* thread) {
+    //the io and CPU time totals are updated as the bursts are scheduled
 
-    for (int proc = 0; proc < num_processes; ++proc) {
-        auto process = read_process(input_file);
+    //update thread type counts
+    this->system_stats.thread_counts[thread->priority]++;
 
-        this->processes[process->process_id] = process;
+    //add to total repsonse times and turnaround times
+    this->system_stats.total_thread_response_times[thread->priority] += thread->response_time();
+    this->system_stats.total_thread_turnaround_times[thread->priority] += thread->turnaround_time();
+
+    this->system_stats.response_time_histograms[thread->priority].record(thread->response_time());
+    this->system_stats.turnaround_time_histograms[thread->priority].record(thread->turnaround_time());
+}
+
+SystemStats Simulation::calculate_statistics() {
+    //the totals were accumulated as threads exited, so only the derived values are left
+    this->system_stats.total_cpu_time = this->system_stats.service_time; //service time same as total cpu time?
+    for(int i = 0; i < 4; i++){
+        if(this->system_stats.thread_counts[i] != 0){
+            this->system_stats.avg_thread_response_times[i] = (double)this->system_stats.total_thread_response_times[i] / this->system_stats.thread_counts[i];
+            this->system_stats.avg_thread_turnaround_times[i] = (double)this->system_stats.total_thread_turnaround_times[i] / this->system_stats.thread_counts[i];
+        }
+    }
+    this->system_stats.total_idle_time = this->system_stats.total_time - this->system_stats.service_time - this->system_stats.dispatch_time;
+    this->system_stats.cpu_utilization = ((double)(this->system_stats.dispatch_time + this->system_stats.service_time) / this->system_stats.total_time) * 100;
+    this->system_stats.cpu_efficiency = ((double)this->system_stats.service_time / this->system_stats.total_time) * 100;
+
+    if (this->flags.arrival_rate > 0) {
+        this->steady_state = this->steady_recorder.analyze(this->flags.warmup, this->offered_load);
     }
+    return this->system_stats;
 }
 
-std::shared_ptr<Process> Simulation::read_process(std::istream& input) {
-    int process_id, priority;
-    int num_threads;
+void Simulation::add_event(const Event& event) {
+    this->events.push(event);
+}
 
-    input >> process_id >> priority >> num_threads;
+std::shared_ptr<const Workload> Simulation::load_workload(const FlagOptions& flags) {
+    if (flags.generate.empty() && flags.arrival_rate <= 0) {
+        return Workload::read_file(flags.filename);
+    }
 
-    auto process = std::make_shared<Process>(process_id, (ProcessPriority) priority);
+    GeneratorOptions options;
+    if (!options.parse(flags.generate)) {
+        throw(std::logic_error("Bad generator options."));
+    }
 
-    // iterate over the threads
-    for (int thread_id = 0; thread_id < num_threads; ++thread_id) {
-        process->threads.emplace_back(read_thread(input, thread_id, process_id, (ProcessPriority) priority));
+    if (flags.arrival_rate > 0) {
+        // The threads of an open system are generated as the run goes; the
+        // workload only holds the overheads.
+        auto workload = std::make_shared<Workload>();
+        workload->thread_switch_overhead = options.thread_switch_overhead;
+        workload->process_switch_overhead = options.process_switch_overhead;
+        return workload;
     }
+    return generate_workload(options);
+}
 
-    return process;
+void Simulation::read_file(const std::string filename) {
+    this->workload = Workload::read_file(filename);
 }
 
-std::shared_ptr<Thread> Simulation::read_thread(std::istream& input, int thread_id, int process_id, ProcessPriority priority) {
-    // Stuff
-    int arrival_time;
-    int num_cpu_bursts;
+void Simulation::instantiate_workload() {
+    this->thread_switch_overhead = this->workload->thread_switch_overhead;
+    this->process_switch_overhead = this->workload->process_switch_overhead;
 
-    input >> arrival_time >> num_cpu_bursts;
+    // Arrivals are numbered 0..N-1 in arrival order, so the events created while
+    // simulating start after them.
+    this->next_arrival = 0;
+    this->event_num = this->workload->threads.size();
 
-    auto thread = std::make_shared<Thread>(arrival_time, thread_id, process_id, priority);
+    this->horizon = SIM_TIME_MAX;
+    if (this->flags.arrival_rate > 0) {
+        this->horizon = this->flags.duration;
+    }
+    if (this->flags.max_time > 0) {
+        this->horizon = std::min(this->horizon, this->flags.max_time);
+    }
+    if (this->flags.converge > 0) {
+        this->convergence = std::make_unique<ConvergenceMonitor>(this->flags.converge);
+    }
 
-    for (int n = 0, burst_length; n < num_cpu_bursts * 2 - 1; ++n) {
-        input >> burst_length;
+    if (this->flags.arrival_rate > 0) {
+        GeneratorOptions options;
+        options.parse(this->flags.generate);
+        options.num_threads = SIZE_MAX;
+        options.interarrival = Distribution::exponential(1.0 / this->flags.arrival_rate);
 
-        BurstType burst_type = (n % 2 == 0) ? BurstType::CPU : BurstType::IO;
+        this->offered_load = this->flags.arrival_rate * options.mean_cpu_demand() * 100;
+        this->open_arrivals = std::make_unique<ThreadGenerator>(options, this->flags.duration);
+        this->next_open_arrival();
+    }
 
-        thread->bursts.push(std::make_shared<Burst>(burst_type, burst_length));
+    if (this->flags.retire) {
+        return;
     }
 
-    this->events.push(std::make_shared<Event>(EventType::THREAD_ARRIVED, thread->arrival_time, this->event_num, thread, nullptr));
-    this->event_num++;
+    this->process_table.reserve(this->workload->processes.size());
+    for (const ProcessSpec& process_spec : this->workload->processes) {
+        auto process = this->arena.create<Process>(process_spec.process_id, process_spec.priority, &this->arena);
+        // Filled in by create_thread as the threads arrive.
+        process->threads.resize(process_spec.num_threads, nullptr);
 
-    return thread;
+        this->process_table.push_back(process);
+        this->processes[process->process_id] = process;
+    }
 }
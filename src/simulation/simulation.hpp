@@ -1,10 +1,13 @@
 #ifndef SIMULATION_HPP
 #define SIMULATION_HPP
 
+#include <chrono>
+#include <csignal>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <queue>
 #include <string>
 
@@ -13,16 +16,31 @@
 #include "types/thread/thread.hpp"
 #include "types/system_stats/system_stats.hpp"
 #include "types/event/event.hpp"
+#include "types/run_info/run_info.hpp"
+#include "types/workload/workload.hpp"
 
+#include "utilities/checkpoint/checkpoint.hpp"
+#include "utilities/chrome_trace/chrome_trace.hpp"
 #include "utilities/flags/flags.hpp"
+#include "utilities/generator/generator.hpp"
 #include "utilities/logger/logger.hpp"
+#include "utilities/memory/arena.hpp"
+#include "utilities/profiler/profiler.hpp"
+#include "utilities/steady_state/steady_state.hpp"
+#include "utilities/thread_export/thread_export.hpp"
+#include "utilities/trace/trace.hpp"
 
-using EventQueue = std::priority_queue<std::shared_ptr<Event>, std::vector<std::shared_ptr<Event>>, EventComparator>;
+using EventQueue = std::priority_queue<Event, std::pmr::vector<Event>, EventComparator>;
 
 /*
     Simulation:
         A class that encapsulates the entire simulation logic. Contains all the member variables
         and functions needed to execute a CPU scheduling simulation.
+
+        The simulation keeps the loaded workload (immutable, possibly shared with other
+        simulations) separate from the state of the current run (threads, events, scheduler
+        queues, statistics). reset() throws the run state away, so the same workload can be
+        simulated again under a different configuration without re-reading the file.
 */
 
 class Simulation {
@@ -32,11 +50,159 @@ public:
     //  Member variables
     //==================================================
 
+    /*
+        workload:
+            The loaded simulation file. Never modified by a run, so it may be shared
+            between several simulations. nullptr until a file has been read.
+    */
+    std::shared_ptr<const Workload> workload;
+
+    /*
+        arena:
+            The memory every per-run object comes from: processes, threads, bursts and
+            the storage of the event queue. It is released in one shot by reset(), so
+            nothing is freed object by object. Declared first so that it
+            outlives the containers that allocate from it.
+    */
+    Arena arena;
+
+    /*
+        thread_pool:
+            Where the per-run threads and their bursts are allocated. It hands out
+            blocks from the arena and reuses the blocks of retired threads (see
+            flags.retire), so with retirement on the memory held by threads stays
+            proportional to the number of threads alive at the same time.
+    */
+    std::pmr::unsynchronized_pool_resource thread_pool{&arena};
+
+    /*
+        large_bursts:
+            Where the burst arrays too large for thread_pool's blocks are allocated.
+            thread_pool would pass them straight on to the arena, which never frees
+            anything, so they are given an upstream that frees each one as its thread
+            is retired. Whatever is left is freed by reset().
+    */
+    std::pmr::unsynchronized_pool_resource large_bursts{std::pmr::new_delete_resource()};
+
     /*
         processes:
-            A map of process IDs to their corresponding process object.
+            A map of process IDs to their corresponding process object for the current
+            run. The processes, their threads and the map's nodes live in the arena.
+    */
+    std::pmr::map<int, Process*> processes{&arena};
+
+    /*
+        process_table:
+            The per-run process for each entry of workload->processes (same index),
+            used to file threads under their process as they arrive. Empty when threads
+            are retired, since nothing is kept per process then.
+    */
+    std::pmr::vector<Process*> process_table{&arena};
+
+    /*
+        next_arrival:
+            The position in workload->arrival_order of the next thread to arrive.
+            Arrivals are fed to the event loop straight from the workload rather than
+            being queued as events, and a thread's Thread object is only created when
+            it arrives.
+    */
+    size_t next_arrival = 0;
+
+    /*
+        open_arrivals, open_thread, open_bursts:
+            In an open system (flags.arrival_rate > 0), where arrivals come from
+            instead of the workload, and the next thread to arrive with its bursts.
+            open_arrivals is null once no more threads arrive before the end.
+    */
+    std::unique_ptr<ThreadGenerator> open_arrivals;
+    ThreadSpec open_thread;
+    std::vector<Burst> open_bursts;
+
+    /*
+        horizon:
+            No event after this time is processed: it is the end of an open system's
+            duration or flags.max_time, whichever comes first (SIM_TIME_MAX for neither).
+    */
+    SimTime horizon = SIM_TIME_MAX;
+
+    /*
+        completed_threads:
+            How many threads have exited so far.
+    */
+    uint64_t completed_threads = 0;
+
+    /*
+        convergence, converged:
+            With flags.converge, watches the turnaround times of exiting threads, and
+            whether they have converged (which stops the run).
+    */
+    std::unique_ptr<ConvergenceMonitor> convergence;
+    bool converged = false;
+
+    /*
+        steady_recorder, steady_state:
+            In an open system, what is recorded about the exiting threads, and the
+            steady-state metrics computed from it at the end.
     */
-    std::map<int, std::shared_ptr<Process>> processes;
+    SteadyStateRecorder steady_recorder;
+    SteadyStateReport steady_state;
+
+    /*
+        offered_load:
+            In an open system, the expected CPU utilization asked for by the arrival
+            rate and thread shape, in percent.
+    */
+    double offered_load = 0.0;
+
+    /*
+        next_checkpoint:
+            With flags.checkpoint_file, when the next periodic checkpoint is due.
+    */
+    std::chrono::steady_clock::time_point next_checkpoint;
+
+    /*
+        interrupts_seen:
+            How many SIGTERM/SIGINT signals had come in when this run started: any
+            more than that stops it (with flags.checkpoint_file).
+    */
+    std::sig_atomic_t interrupts_seen = 0;
+
+    /*
+        retired_thread:
+            The most recently retired thread, whose memory is only given back when the
+            next thread retires: prev_thread may still point to it until then.
+    */
+    Thread* retired_thread = nullptr;
+
+    /*
+        exporter:
+            Where the metrics of exited threads are written, if flags.export_file is set.
+            Opened by run() for the whole run.
+    */
+    std::unique_ptr<ThreadExporter> exporter;
+
+    /*
+        trace:
+            Where the state transitions and scheduling decisions are recorded, if
+            flags.trace_file is set. Opened by run() for the whole run.
+    */
+    std::unique_ptr<TraceWriter> trace;
+
+    /*
+        chrome_trace:
+            Where the schedule is written as a Chrome trace, if flags.chrome_trace_file
+            is set. Opened by run() for the whole run.
+    */
+    std::unique_ptr<ChromeTraceWriter> chrome_trace;
+
+    /*
+        async_logger:
+            With flags.async_log, the logger output produced while simulating (verbose
+            output and the summaries of retired threads) is recorded here and printed
+            by a background thread instead of the simulation thread. Opened by run()
+            for the whole run.
+    */
+    std::unique_ptr<AsyncLogger> async_logger;
 
     /*
         scheduler:
@@ -52,40 +218,62 @@ public:
             The thread that is currently on the CPU. If no thread is on the
             CPU, it should point to nullptr.
     */
-    std::shared_ptr<Thread> active_thread = nullptr;
+    Thread* active_thread = nullptr;
 
     /*
         prev_thread:
             The thread that was previously on the CPU, or nullptr if there was
             not thread previously on the CPU.
     */
-    std::shared_ptr<Thread> prev_thread = nullptr;
+    Thread* prev_thread = nullptr;
 
     /*
         thread_switch_overhead:
             An integer for the thread switch overhead, as specified in the simulation file.
+            Copied from the workload when a run starts.
     */
-    int thread_switch_overhead;
+    SimTime thread_switch_overhead;
 
     /*
         process_switch_overhead:
             An integer for the process switch overhead, as specified in the simulation file.
+            Copied from the workload when a run starts.
     */
-    int process_switch_overhead;
+    SimTime process_switch_overhead;
 
     /*
         event_num:
             An integer representing how many events that the simulation has created. This is
             used in the Event class so that we can break ties in the event queue.
     */
-    unsigned int event_num = 0;
+    uint64_t event_num = 0;
 
     /*
         events:
             Our priority queue of events. This is what we add new events to,
-            and take events from to progress through the simulation.
+            and take events from to progress through the simulation. Its storage lives
+            in the arena.
     */
-    EventQueue events;
+    EventQueue events{EventComparator(), std::pmr::vector<Event>(&arena)};
+
+    /*
+        current_event:
+            The event processed by the last call to step().
+    */
+    Event current_event;
+
+    /*
+        run_info:
+            The configuration of the last run and how much work simulating it took.
+    */
+    RunInfo run_info;
+
+    /*
+        profiler:
+            The simulator's own performance counters for the last run, reported with
+            --profile. Only updated in builds with profiling compiled in.
+    */
+    Profiler profiler;
 
     /*
         system_stats:
@@ -103,10 +291,16 @@ public:
     /*
         flags:
             The flags that the user passed into the command line when they
-            invoked the program.
+            invoked the program, or the configuration of the current run.
     */
     FlagOptions flags;
 
+    /*
+        output:
+            Where the simulation prints its output (standard output by default).
+    */
+    std::ostream* output = &std::cout;
+
     //==================================================
     //  Member functions
     //==================================================
@@ -124,14 +318,54 @@ public:
     */
     Simulation(FlagOptions flags);
 
+    /*
+        Simulation(workload, flags):
+            A constructor for a simulation of an already loaded workload.
+    */
+    Simulation(std::shared_ptr<const Workload> workload, FlagOptions flags);
+
     /*
         run():
             The main loop of the simulation. This function reads in the
-            specified simulation file, populates all the required data structure,
-            and then begins the next-event simulation for the CPU scheduler.
+            specified simulation file (unless a workload is already loaded), populates
+            all the required data structure, begins the next-event simulation for the
+            CPU scheduler and prints the results asked for by the flags.
     */
     void run();
 
+    /*
+        run(config):
+            Resets the simulation and simulates the loaded workload from the start under
+            the given configuration (algorithm, time slice, logging flags). Returns the
+            statistics of the run. Unlike run(), it does not print the end-of-run report;
+            call report() for that. The state of the run stays available until the next
+            reset().
+    */
+    SystemStats run(const FlagOptions& config);
+
+    /*
+        start(config):
+            Resets the simulation and prepares a run of the loaded workload under the
+            given configuration without processing any event. The run is then driven
+            with step() (or simulate()), which lets two runs be compared event by event.
+    */
+    void start(const FlagOptions& config);
+
+    /*
+        reset():
+            Discards all per-run state (threads, events, statistics), creates a fresh
+            scheduler for the configured algorithm and releases the arena. The workload
+            is kept.
+    */
+    void reset();
+
+    /*
+        report():
+            Prints the end-of-run output for the last run: the completion banner, the
+            per-thread metrics and the simulation metrics, as enabled by the flags.
+    */
+    void report();
+
     /*
         handle_*:
             These functions are handler functions that are called for each
@@ -146,58 +380,189 @@ public:
             Deliverable 1 of this project, and then for Deliverable 2 you will have to implement
             them.
     */
-    void handle_thread_arrived(const std::shared_ptr<Event> event);
+    void handle_thread_arrived(const Event& event);
 
-    void handle_dispatch_completed(const std::shared_ptr<Event> event);
+    void handle_dispatch_completed(const Event& event);
 
-    void handle_cpu_burst_completed(const std::shared_ptr<Event> event);
+    void handle_cpu_burst_completed(const Event& event);
 
-    void handle_io_burst_completed(const std::shared_ptr<Event> event);
+    void handle_io_burst_completed(const Event& event);
 
-    void handle_thread_completed(const std::shared_ptr<Event> event);
+    void handle_thread_completed(const Event& event);
 
-    void handle_thread_preempted(const std::shared_ptr<Event> event);
+    void handle_thread_preempted(const Event& event);
 
-    void handle_dispatcher_invoked(const std::shared_ptr<Event> event);
+    void handle_dispatcher_invoked(const Event& event);
 
     //helper function for handle_dispatch_completed
     //checks if we are on last burst and creates events accordingly
-    void dispatch_completed_helper(const std::shared_ptr<Event> event, const std::shared_ptr<Burst> b);
+    void dispatch_completed_helper(const Event& event, const Burst* b);
 
     /*
         read_file(filename):
-            This function reads in the simulation file, as specified by filename. If filename is
-            blank, then it reads in from stdin.
+            This function reads in the simulation file, as specified by filename, and
+            keeps it as the workload to simulate.
     */
     void read_file(const std::string filename);
 
     /*
-        read_process(input):
-            Reads in a process from the simulation file. Called by read_file
-            for each process that is provided in the simulation file.
+        load_workload(flags):
+            Returns the workload selected by the flags: generated in memory with -g,
+            otherwise read from the simulation file.
+    */
+    static std::shared_ptr<const Workload> load_workload(const FlagOptions& flags);
+
+    /*
+        set_output(output):
+            Makes the simulation print everything to output instead of standard output.
+            The stream must outlive the simulation's use of it.
+    */
+    void set_output(std::ostream& output);
+
+    /*
+        configure(config):
+            Sets the flags and logger for a run with the given configuration. The
+            scheduler they select is created by reset().
+    */
+    void configure(const FlagOptions& config);
+
+    /*
+        instantiate_workload():
+            Prepares a run of the loaded workload: copies the overheads, creates the
+            per-run processes (unless threads are retired) and points the arrival
+            cursor at the first thread to arrive.
+    */
+    void instantiate_workload();
+
+    /*
+        simulate():
+            Runs the event loop until there are no more events or arrivals.
+    */
+    void simulate();
+
+    /*
+        step():
+            Processes the next event (kept in current_event) and returns true, or
+            returns false if there is nothing left to process or a stop condition
+            (FlagOptions::max_time and the following) has ended the run. Statistics
+            are only calculated by simulate().
+    */
+    bool step();
+
+    /*
+        work_remaining():
+            Whether any event or arrival is left to process.
+    */
+    bool work_remaining() const;
+
+    /*
+        stop(reason, stop_time):
+            Ends the run early at stop_time: records the reason in run_info, discards
+            the events left and takes the work they had scheduled after stop_time out
+            of the time totals, so the statistics cover exactly [0, stop_time]. The
+            per-thread and per-priority statistics only cover the exited threads.
+    */
+    void stop(const std::string& reason, SimTime stop_time);
+
+    /*
+        save_checkpoint(filename):
+            Saves the state of the run between two events (threads, event queue,
+            scheduler queues, statistics and open-system generator) to filename. The
+            workload is not saved: it is loaded again on restore. Throws
+            std::logic_error if the file cannot be written.
+    */
+    void save_checkpoint(const std::string& filename) const;
+
+    /*
+        restore_checkpoint(filename):
+            Replaces the state of a freshly reset run with the one saved in filename,
+            so that simulating on gives exactly the results the saved run would have.
+            Throws std::logic_error if the checkpoint is unreadable or was made with a
+            different workload or configuration.
+    */
+    void restore_checkpoint(const std::string& filename);
+
+    /*
+        apply_branch_time_slice(queued):
+            When a run branches from a prefix run with another scheduler, makes the
+            prefix's events in flight follow the new scheduler's time slice: pending
+            dispatches take it, and the running thread's CPU run is re-timed from its
+            start with it, ending no earlier than the branch point.
+    */
+    void apply_branch_time_slice(std::pmr::vector<Event>& queued);
+
+    /*
+        checkpoint_config():
+            What a checkpoint must have been made with to be restored in this run: the
+            workload and the options that change what happens in the run (except the
+            scheduler when branching, see FlagOptions::branch_at).
+    */
+    std::string checkpoint_config() const;
+
+    /*
+        next_event(event):
+            Takes the next event to process: the next arrival from the workload if it
+            is due no later than the first queued event (arrivals win ties, like they
+            did when they were queued before every other event), otherwise the first
+            queued event. Returns false when there is nothing left.
+    */
+    bool next_event(Event& event);
+
+    /*
+        create_thread(spec_index):
+            Creates the per-run Thread for workload->threads[spec_index], with its own
+            copy of its bursts, and files it under its process unless threads are
+            being retired.
+    */
+    Thread* create_thread(size_t spec_index);
+
+    /*
+        allocate_thread(spec, bursts, handle):
+            Creates a Thread for spec in the thread pool, with its own copy of the
+            spec.num_bursts bursts starting at bursts.
+    */
+    Thread* allocate_thread(const ThreadSpec& spec, const Burst* bursts, uint32_t handle);
+
+    /*
+        burst_resource(num_bursts):
+            Where a thread's array of num_bursts bursts is allocated and freed.
+    */
+    std::pmr::memory_resource* burst_resource(size_t num_bursts);
+
+    /*
+        next_open_arrival():
+            Generates the next thread of an open system into open_thread.
+    */
+    void next_open_arrival();
+
+    /*
+        retire_thread(thread):
+            Emits the summary of an exited thread (when per-thread output is on) and
+            gives its memory back to the thread pool. Only used when flags.retire is set.
     */
-    std::shared_ptr<Process> read_process(std::istream& input);
+    void retire_thread(Thread* thread);
 
     /*
-        read_thread(input, thread_id, process_id, priority):
-            Reads in a thread from the simulation file. Called by read_process
-            for each thread in a process, as provided by the simulation file.
+        record_thread_statistics(thread):
+            Adds an exited thread's times to the running totals in system_stats.
+            Called once per thread, when it exits.
     */
-    std::shared_ptr<Thread> read_thread(std::istream& input, int thread_id, int process_id, ProcessPriority priority);
+    void record_thread_statistics(const Thread* thread);
 
     /*
         calculate_statistics():
             Calculates some useful statistics for the simulation, and stores them
-            in a SystemStats object.
+            in a SystemStats object. The totals are already up to date when the event
+            loop ends, so this only derives the averages and percentages (it does not
+            look at individual threads).
     */
     SystemStats calculate_statistics();
 
     /*
         add_event(event):
-            Checks to see if the event is not a nullptr,
-            then adds it to the event queue.
+            Adds the event to the event queue.
     */
-    void add_event(std::shared_ptr<Event> event);
+    void add_event(const Event& event);
 };
 
 #endif
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+#include "algorithms/scheduler_registry.hpp"
+#include "simulation/simulation.hpp"
+#include "utilities/generator/generator.hpp"
+#include "utilities/temp_file/temp_file.hpp"
+
+/*
+    cpu-sim-bench:
+        Benchmarks the simulator on synthetic workloads of growing size (powers of ten
+        from --min_threads to --max_threads) with every registered algorithm, and
+        prints one CSV row per (algorithm, size):
+
+            algorithm,threads,events,load_ms,simulate_ms,events_per_sec,peak_rss_kb,wall_ms
+
+        load_ms is the time to read the workload back from a simulation file (written
+        once per size to a temporary file, removed at the end, or to --file, which is
+        kept), simulate_ms the time of the run itself, and wall_ms
+        their sum. peak_rss_kb is the peak resident memory of the process so far, so
+        it only grows from row to row.
+
+        The makefile builds it with -O2 -DNDEBUG; it says on stderr whether it was
+        optimized.
+
+        Usage: cpu-sim-bench [--min_threads N] [--max_threads N] [--algorithms A,B]
+                             [--time_slice N] [--seed N] [--file path]
+*/
+
+static double milliseconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+    size_t min_threads = 1000;
+    size_t max_threads = 1000000;
+    int time_slice = 5;
+    uint64_t seed = 1;
+    std::string filename = "";
+    std::vector<std::string> algorithms = registered_algorithms();
+
+    static struct option options[] = {
+        {"min_threads", required_argument, 0, 'n'},
+        {"max_threads", required_argument, 0, 'x'},
+        {"algorithms",  required_argument, 0, 'a'},
+        {"time_slice",  required_argument, 0, 's'},
+        {"seed",        required_argument, 0, 'r'},
+        {"file",        required_argument, 0, 'f'},
+        {0, 0, 0, 0}
+    };
+
+    try {
+        int option;
+        while ((option = getopt_long(argc, argv, "n:x:a:s:r:f:", options, nullptr)) != -1) {
+            switch (option) {
+                case 'n': min_threads = std::stoull(optarg); break;
+                case 'x': max_threads = std::stoull(optarg); break;
+                case 'a': algorithms = split_list(optarg); break;
+                case 's': time_slice = std::stoi(optarg); break;
+                case 'r': seed = std::stoull(optarg); break;
+                case 'f': filename = optarg; break;
+                default:
+                    std::cerr << "Usage: cpu-sim-bench [--min_threads N] [--max_threads N] [--algorithms A,B] "
+                                 "[--time_slice N] [--seed N] [--file path]" << std::endl;
+                    return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Bad option value." << std::endl;
+        return 1;
+    }
+
+    for (const std::string& algorithm : algorithms) {
+        if (!is_registered_algorithm(algorithm)) {
+            std::cerr << "Unknown algorithm: " << algorithm << std::endl;
+            return 1;
+        }
+    }
+
+    // On stderr, so the CSV is left as it is.
+#ifdef __OPTIMIZE__
+    std::cerr << "cpu-sim-bench: optimized build" << std::endl;
+#else
+    std::cerr << "cpu-sim-bench: unoptimized build, timings are not representative" << std::endl;
+#endif
+
+    std::cout << "algorithm,threads,events,load_ms,simulate_ms,events_per_sec,peak_rss_kb,wall_ms" << std::endl;
+
+    bool keep_file = !filename.empty();
+    if (!keep_file) {
+        filename = temporary_file("cpu-sim-bench");
+    }
+
+    for (size_t size = std::max<size_t>(1, min_threads); size <= max_threads; size *= 10) {
+        GeneratorOptions generator;
+        generator.num_threads = size;
+        generator.seed = seed;
+
+        {
+            std::ofstream output(filename.c_str());
+            generate_workload(generator)->write(output);
+        }
+
+        auto load_start = std::chrono::steady_clock::now();
+        auto workload = Workload::read_file(filename);
+        double load_ms = milliseconds_since(load_start);
+
+        for (const std::string& algorithm : algorithms) {
+            FlagOptions config;
+            config.filename = filename;
+            config.scheduler = algorithm;
+            config.time_slice = is_preemptive_algorithm(algorithm) ? time_slice : -1;
+
+            Simulation simulation(workload, config);
+            simulation.run(config);
+
+            const RunInfo& info = simulation.run_info;
+            double simulate_ms = info.wall_time_ns / 1e6;
+            double events_per_sec = info.wall_time_ns == 0 ? 0.0 : info.events_processed * 1e9 / info.wall_time_ns;
+
+            std::printf("%s,%zu,%llu,%.3f,%.3f,%.0f,%ld,%.3f\n", algorithm.c_str(), size,
+                (unsigned long long) info.events_processed, load_ms, simulate_ms, events_per_sec,
+                peak_rss_kb(), load_ms + simulate_ms);
+            std::fflush(stdout);
+        }
+    }
+
+    if (!keep_file) {
+        std::remove(filename.c_str());
+    }
+    return 0;
+}
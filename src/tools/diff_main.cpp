@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "algorithms/scheduler_registry.hpp"
+#include "simulation/simulation.hpp"
+#include "types/enums.hpp"
+#include "utilities/generator/generator.hpp"
+
+/*
+    cpu-sim-diff:
+        Differential checker. Runs an independent reference engine (ReferenceEngine
+        below) and the simulator's engine, with and without --retire, side by side on
+        the same workload, one event at a time. After every event it compares the event
+        (time, type, number), the thread it is about, that thread's state transition
+        and the scheduling decision it carries; at the end it compares the simulation
+        metrics. The first divergence of each run is reported.
+
+        The reference engine shares no simulation code with Simulation, so everything
+        Simulation does is cross-checked: the event queue and the arrival feed, the
+        arena and thread retirement, the event handlers, the ring-buffer schedulers
+        and the by-value SchedulingDecision path, and the incremental statistics. Only
+        the Workload (file parsing and generation) and LatencyHistogram, used for the
+        ready-wait percentiles, are shared, so a bug in those is not caught.
+
+        Without --file, it fuzzes: every seed generates a workload of a random shape
+        (size, burst counts and lengths, arrival rate, overheads), which is checked with
+        every algorithm. The workload of the first divergence is written to --output
+        so it can be replayed with cpu-sim or cpu-sim-diff --file.
+
+        Exits with 1 if anything diverged.
+
+        Usage: cpu-sim-diff [--file path] [--seeds N] [--first_seed N] [--threads N]
+                            [--algorithms A,B] [--time_slice N] [--output path]
+*/
+
+/*
+    EventSnapshot:
+        Everything compared about one processed event. Threads are identified by their
+        IDs, not their addresses, since every engine has its own.
+*/
+struct EventSnapshot {
+    EventType type = THREAD_ARRIVED;
+    SimTime time = 0;
+    uint64_t event_num = 0;
+    int process_id = -1;
+    int thread_id = -1;
+    ThreadState before = NEW;
+    ThreadState after = NEW;
+    int decision_process_id = -1;
+    int decision_thread_id = -1;
+    int time_slice = -1;
+    DecisionReason reason = NO_THREAD_READY;
+
+    bool operator==(const EventSnapshot& other) const {
+        return type == other.type && time == other.time && event_num == other.event_num
+            && process_id == other.process_id && thread_id == other.thread_id
+            && before == other.before && after == other.after
+            && decision_process_id == other.decision_process_id
+            && decision_thread_id == other.decision_thread_id
+            && time_slice == other.time_slice && reason == other.reason;
+    }
+
+    std::string describe() const {
+        std::string text = "time " + std::to_string(time) + ", #" + std::to_string(event_num) + " " + EVENT_TYPE_NAMES[type];
+        if (thread_id >= 0) {
+            text += ", thread " + std::to_string(thread_id) + " in process " + std::to_string(process_id)
+                + " " + THREAD_STATE_NAMES[before] + " -> " + THREAD_STATE_NAMES[after];
+        }
+        if (decision_thread_id >= 0) {
+            text += ", decision: thread " + std::to_string(decision_thread_id) + " in process "
+                + std::to_string(decision_process_id) + " (slice " + std::to_string(time_slice)
+                + ", reason " + std::to_string((int) reason) + ")";
+        }
+        return text;
+    }
+};
+
+static EventSnapshot snapshot(const Event& event) {
+    EventSnapshot snap;
+    snap.type = event.type;
+    snap.time = event.time;
+    snap.event_num = event.event_num;
+    if (event.thread) {
+        snap.process_id = event.thread->process_id;
+        snap.thread_id = event.thread->thread_id;
+        snap.before = event.thread->previous_state;
+        snap.after = event.thread->current_state;
+    }
+    const SchedulingDecision& decision = event.scheduling_decision;
+    if (decision.thread) {
+        snap.decision_process_id = decision.thread->process_id;
+        snap.decision_thread_id = decision.thread->thread_id;
+    }
+    snap.time_slice = decision.time_slice;
+    snap.reason = decision.reason;
+    return snap;
+}
+
+// The reference engine's own threads, scheduling decisions and events.
+struct ReferenceThread {
+    int process_id;
+    int thread_id;
+    ProcessPriority priority;
+    SimTime arrival_time;
+    SimTime start_time = -1;
+    SimTime end_time = -1;
+    SimTime state_change_time = 0;
+    ThreadState state = NEW;
+    ThreadState previous_state = NEW;
+    // The lengths of the bursts: CPU at even indices, IO at odd ones.
+    std::vector<SimTime> bursts;
+    size_t next_burst = 0;
+
+    void set_state(ThreadState new_state, SimTime time) {
+        previous_state = state;
+        state = new_state;
+        state_change_time = time;
+    }
+};
+
+struct ReferenceDecision {
+    ReferenceThread* thread = nullptr;
+    int time_slice = -1;
+    DecisionReason reason = NO_THREAD_READY;
+};
+
+struct ReferenceEvent {
+    EventType type;
+    SimTime time;
+    uint64_t number;
+    ReferenceThread* thread;
+    ReferenceDecision decision;
+};
+
+/*
+    ReferenceEngine:
+        The simulation rules written out plainly, for clarity rather than speed:
+        threads are structs in a vector, every arrival is queued before the first
+        event, the event queue is a std::map ordered by (time, event number), the
+        ready queues are std::deques, a thread's CPU burst is shortened when its
+        preemption is scheduled, and the metrics are computed in one pass over the
+        threads at the end. Knows FCFS, RR and PRIORITY.
+*/
+class ReferenceEngine {
+public:
+    ReferenceEngine(std::shared_ptr<const Workload> workload, const std::string& algorithm, int time_slice);
+
+    /*
+        step():
+            Processes the next event. Returns false if there are none left.
+    */
+    bool step();
+
+    /*
+        current():
+            The last event processed, as compared with the other engine.
+    */
+    EventSnapshot current() const { return this->last; }
+
+    /*
+        statistics():
+            The metrics of the run so far.
+    */
+    SystemStats statistics() const;
+
+private:
+    std::string algorithm;
+    int time_slice;
+    SimTime thread_switch_overhead;
+    SimTime process_switch_overhead;
+    std::vector<ReferenceThread> threads;
+    std::map<std::pair<SimTime, uint64_t>, ReferenceEvent> events;
+    uint64_t event_num;
+    std::deque<ReferenceThread*> ready[4];
+    ReferenceThread* active = nullptr;
+    ReferenceThread* previous = nullptr;
+    SystemStats stats;
+    EventSnapshot last;
+
+    void push(EventType type, SimTime time, ReferenceThread* thread, const ReferenceDecision& decision = ReferenceDecision()) {
+        this->event_num++;
+        this->events.emplace(std::make_pair(time, this->event_num),
+            ReferenceEvent{type, time, this->event_num, thread, decision});
+    }
+
+    void make_ready(ReferenceThread* thread, SimTime time) {
+        thread->set_state(READY, time);
+        this->ready[this->algorithm == "PRIORITY" ? thread->priority : 0].push_back(thread);
+    }
+
+    ReferenceDecision pick();
+    void handle(const ReferenceEvent& event);
+};
+
+ReferenceEngine::ReferenceEngine(std::shared_ptr<const Workload> workload, const std::string& algorithm, int time_slice):
+    algorithm(algorithm), thread_switch_overhead(workload->thread_switch_overhead),
+    process_switch_overhead(workload->process_switch_overhead), event_num(workload->threads.size()) {
+    if (algorithm == "RR") {
+        this->time_slice = time_slice <= 0 ? 3 : time_slice;
+    } else if (algorithm == "FCFS" || algorithm == "PRIORITY") {
+        this->time_slice = -1;
+    } else {
+        std::cerr << "The reference engine does not implement " << algorithm << "." << std::endl;
+        throw(std::logic_error("Bad algorithm."));
+    }
+
+    for (const ThreadSpec& spec : workload->threads) {
+        ReferenceThread thread;
+        thread.process_id = spec.process_id;
+        thread.thread_id = spec.thread_id;
+        thread.priority = spec.priority;
+        thread.arrival_time = spec.arrival_time;
+        for (size_t i = 0; i < spec.num_bursts; ++i) {
+            thread.bursts.push_back(workload->bursts[spec.first_burst + i].length);
+        }
+        this->threads.push_back(thread);
+    }
+
+    // Arrivals are numbered 0..N-1 in arrival order (ties in file order), before
+    // any other event.
+    std::vector<size_t> order(this->threads.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return this->threads[a].arrival_time < this->threads[b].arrival_time;
+    });
+    for (size_t i = 0; i < order.size(); ++i) {
+        ReferenceThread* thread = &this->threads[order[i]];
+        this->events.emplace(std::make_pair(thread->arrival_time, (uint64_t) i),
+            ReferenceEvent{THREAD_ARRIVED, thread->arrival_time, i, thread, ReferenceDecision()});
+    }
+}
+
+ReferenceDecision ReferenceEngine::pick() {
+    ReferenceDecision decision;
+    decision.time_slice = this->time_slice;
+    for (std::deque<ReferenceThread*>& queue : this->ready) {
+        if (!queue.empty()) {
+            decision.thread = queue.front();
+            queue.pop_front();
+            decision.reason = this->algorithm == "FCFS" ? RUN_TO_COMPLETION
+                            : this->algorithm == "RR" ? TIME_SLICE : PRIORITY_QUEUE;
+            break;
+        }
+    }
+    return decision;
+}
+
+bool ReferenceEngine::step() {
+    if (this->events.empty()) {
+        return false;
+    }
+    ReferenceEvent event = this->events.begin()->second;
+    this->events.erase(this->events.begin());
+
+    this->handle(event);
+    this->stats.total_time = event.time;
+
+    this->last = EventSnapshot();
+    this->last.type = event.type;
+    this->last.time = event.time;
+    this->last.event_num = event.number;
+    if (event.thread != nullptr) {
+        this->last.process_id = event.thread->process_id;
+        this->last.thread_id = event.thread->thread_id;
+        this->last.before = event.thread->previous_state;
+        this->last.after = event.thread->state;
+    }
+    if (event.decision.thread != nullptr) {
+        this->last.decision_process_id = event.decision.thread->process_id;
+        this->last.decision_thread_id = event.decision.thread->thread_id;
+    }
+    this->last.time_slice = event.decision.time_slice;
+    this->last.reason = event.decision.reason;
+    return true;
+}
+
+void ReferenceEngine::handle(const ReferenceEvent& event) {
+    ReferenceThread* thread = event.thread;
+
+    switch (event.type) {
+        case THREAD_ARRIVED:
+        case IO_BURST_COMPLETED:
+            this->make_ready(thread, event.time);
+            if (this->active == nullptr) {
+                this->push(DISPATCHER_INVOKED, event.time, nullptr);
+            }
+            break;
+
+        case THREAD_DISPATCH_COMPLETED:
+        case PROCESS_DISPATCH_COMPLETED: {
+            if (thread->start_time < 0) {
+                thread->start_time = event.time;
+            }
+            thread->set_state(RUNNING, event.time);
+            SimTime& burst = thread->bursts[thread->next_burst];
+            int slice = event.decision.time_slice;
+            if (slice != -1 && burst > slice) {
+                burst -= slice;
+                this->stats.service_time += slice;
+                this->push(THREAD_PREEMPTED, event.time + slice, thread, event.decision);
+            } else {
+                thread->next_burst++;
+                this->stats.service_time += burst;
+                this->push(thread->next_burst == thread->bursts.size() ? THREAD_COMPLETED : CPU_BURST_COMPLETED,
+                    event.time + burst, thread, event.decision);
+            }
+            break;
+        }
+
+        case CPU_BURST_COMPLETED: {
+            thread->set_state(BLOCKED, event.time);
+            this->previous = this->active;
+            this->active = nullptr;
+            SimTime io = thread->bursts[thread->next_burst++];
+            this->stats.io_time += io;
+            this->push(DISPATCHER_INVOKED, event.time, nullptr);
+            this->push(IO_BURST_COMPLETED, event.time + io, thread, event.decision);
+            break;
+        }
+
+        case THREAD_COMPLETED:
+            thread->set_state(EXIT, event.time);
+            thread->end_time = event.time;
+            this->previous = this->active;
+            this->active = nullptr;
+            this->push(DISPATCHER_INVOKED, event.time, nullptr);
+            break;
+
+        case THREAD_PREEMPTED:
+            this->make_ready(thread, event.time);
+            this->push(DISPATCHER_INVOKED, event.time, nullptr);
+            break;
+
+        case DISPATCHER_INVOKED: {
+            if (this->active != nullptr) {
+                this->previous = this->active;
+            }
+            ReferenceDecision decision = this->pick();
+            this->active = decision.thread;
+            if (decision.thread == nullptr) {
+                break;
+            }
+            ReferenceThread* next = decision.thread;
+            this->stats.ready_wait_histograms[next->priority].record(event.time - next->state_change_time);
+
+            bool same_process = this->previous != nullptr && this->previous->process_id == next->process_id;
+            SimTime overhead = same_process ? this->thread_switch_overhead : this->process_switch_overhead;
+            this->stats.dispatch_time += overhead;
+            this->push(same_process ? THREAD_DISPATCH_COMPLETED : PROCESS_DISPATCH_COMPLETED,
+                event.time + overhead, next, decision);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+SystemStats ReferenceEngine::statistics() const {
+    SystemStats stats = this->stats;
+    for (const ReferenceThread& thread : this->threads) {
+        if (thread.state != EXIT) {
+            continue;
+        }
+        stats.thread_counts[thread.priority]++;
+        stats.total_thread_response_times[thread.priority] += thread.start_time - thread.arrival_time;
+        stats.total_thread_turnaround_times[thread.priority] += thread.end_time - thread.arrival_time;
+    }
+    stats.total_cpu_time = stats.service_time;
+    stats.total_idle_time = stats.total_time - stats.service_time - stats.dispatch_time;
+    stats.cpu_utilization = (double) (stats.dispatch_time + stats.service_time) / stats.total_time * 100;
+    stats.cpu_efficiency = (double) stats.service_time / stats.total_time * 100;
+    return stats;
+}
+
+/*
+    compare_stats(reference, optimized):
+        Returns a description of the first metric that differs, or "" if none does.
+*/
+static std::string compare_stats(const SystemStats& reference, const SystemStats& optimized) {
+    std::string difference;
+    auto check = [&](const std::string& name, double a, double b) {
+        if (difference.empty() && a != b) {
+            std::ostringstream text;
+            text << name << ": " << a << " vs " << b;
+            difference = text.str();
+        }
+    };
+
+    check("total_time", reference.total_time, optimized.total_time);
+    check("total_idle_time", reference.total_idle_time, optimized.total_idle_time);
+    check("dispatch_time", reference.dispatch_time, optimized.dispatch_time);
+    check("service_time", reference.service_time, optimized.service_time);
+    check("io_time", reference.io_time, optimized.io_time);
+    check("cpu_utilization", reference.cpu_utilization, optimized.cpu_utilization);
+    check("cpu_efficiency", reference.cpu_efficiency, optimized.cpu_efficiency);
+    for (int p = 0; p < 4; ++p) {
+        std::string priority = "[" + std::to_string(p) + "]";
+        check("thread_counts" + priority, reference.thread_counts[p], optimized.thread_counts[p]);
+        check("total_thread_response_times" + priority, reference.total_thread_response_times[p],
+            optimized.total_thread_response_times[p]);
+        check("total_thread_turnaround_times" + priority, reference.total_thread_turnaround_times[p],
+            optimized.total_thread_turnaround_times[p]);
+        check("ready wait p99" + priority, reference.ready_wait_histograms[p].percentile(99),
+            optimized.ready_wait_histograms[p].percentile(99));
+    }
+    return difference;
+}
+
+/*
+    check_run(workload, algorithm, time_slice, retire, label):
+        Runs the reference engine and Simulation in lockstep. Prints the first divergence
+        under label and returns false if there is one.
+*/
+static bool check_run(std::shared_ptr<const Workload> workload, const std::string& algorithm, int time_slice,
+                      bool retire, const std::string& label) {
+    FlagOptions config;
+    config.scheduler = algorithm;
+    config.time_slice = is_preemptive_algorithm(algorithm) ? time_slice : -1;
+    config.retire = retire;
+
+    // Nothing is printed by the engine, but keep it off standard output anyway.
+    std::ostringstream discard;
+    ReferenceEngine reference(workload, algorithm, config.time_slice);
+    Simulation optimized(workload, config);
+    optimized.set_output(discard);
+    optimized.start(config);
+
+    std::string engine = retire ? "optimized --retire" : "optimized";
+    for (uint64_t n = 0;; ++n) {
+        bool reference_stepped = reference.step();
+        bool optimized_stepped = optimized.step();
+
+        if (!reference_stepped || !optimized_stepped) {
+            if (reference_stepped != optimized_stepped) {
+                std::cout << label << " (" << engine << "): diverged after " << n << " events: the "
+                          << (reference_stepped ? engine : "reference") << " engine ran out of events first" << std::endl;
+                return false;
+            }
+            break;
+        }
+
+        EventSnapshot expected = reference.current();
+        EventSnapshot actual = snapshot(optimized.current_event);
+        if (!(expected == actual)) {
+            std::cout << label << " (" << engine << "): diverged at event " << n << "\n"
+                      << "    reference: " << expected.describe() << "\n"
+                      << "    " << engine << ": " << actual.describe() << std::endl;
+            return false;
+        }
+    }
+
+    optimized.calculate_statistics();
+    std::string difference = compare_stats(reference.statistics(), optimized.system_stats);
+    if (!difference.empty()) {
+        std::cout << label << " (" << engine << "): same events but different metrics: " << difference << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    random_shape(seed, max_threads):
+        Draws the shape of a fuzzing workload. Small and odd shapes are favoured: ties
+        in arrival times, zero overheads and single-burst threads are where engines
+        tend to disagree.
+*/
+static GeneratorOptions random_shape(uint64_t seed, size_t max_threads) {
+    std::mt19937_64 random(seed);
+    auto uniform = [&](int low, int high) {
+        return std::uniform_int_distribution<int>(low, high)(random);
+    };
+
+    GeneratorOptions options;
+    options.seed = seed;
+    options.num_threads = (size_t) uniform(1, (int) std::max<size_t>(1, max_threads));
+    options.interarrival = Distribution::uniform(0, uniform(0, 120));
+    options.thread_switch_overhead = uniform(0, 5);
+    options.process_switch_overhead = uniform(0, 10);
+    for (PriorityProfile& profile : options.priorities) {
+        profile.weight = uniform(0, 3);
+        profile.threads_per_process = Distribution::uniform(1, uniform(1, 8));
+        profile.cpu_bursts = Distribution::uniform(1, uniform(1, 6));
+        profile.cpu_burst = Distribution::uniform(1, uniform(1, 40));
+        profile.io_burst = Distribution::uniform(1, uniform(1, 40));
+    }
+    options.priorities[uniform(0, 3)].weight += 1;
+    return options;
+}
+
+static std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+    std::string filename = "";
+    uint64_t seeds = 200;
+    uint64_t first_seed = 1;
+    size_t max_threads = 50;
+    int time_slice = 3;
+    std::string output = "diff_failure.txt";
+    std::vector<std::string> algorithms = registered_algorithms();
+
+    static struct option options[] = {
+        {"file",        required_argument, 0, 'f'},
+        {"seeds",       required_argument, 0, 'n'},
+        {"first_seed",  required_argument, 0, 'r'},
+        {"threads",     required_argument, 0, 't'},
+        {"algorithms",  required_argument, 0, 'a'},
+        {"time_slice",  required_argument, 0, 's'},
+        {"output",      required_argument, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+
+    try {
+        int option;
+        while ((option = getopt_long(argc, argv, "f:n:r:t:a:s:o:", options, nullptr)) != -1) {
+            switch (option) {
+                case 'f': filename = optarg; break;
+                case 'n': seeds = std::stoull(optarg); break;
+                case 'r': first_seed = std::stoull(optarg); break;
+                case 't': max_threads = std::stoull(optarg); break;
+                case 'a': algorithms = split_list(optarg); break;
+                case 's': time_slice = std::stoi(optarg); break;
+                case 'o': output = optarg; break;
+                default:
+                    std::cerr << "Usage: cpu-sim-diff [--file path] [--seeds N] [--first_seed N] [--threads N] "
+                                 "[--algorithms A,B] [--time_slice N] [--output path]" << std::endl;
+                    return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Bad option value." << std::endl;
+        return 1;
+    }
+
+    for (const std::string& algorithm : algorithms) {
+        if (!is_registered_algorithm(algorithm)) {
+            std::cerr << "Unknown algorithm: " << algorithm << std::endl;
+            return 1;
+        }
+    }
+
+    size_t runs = 0, failures = 0;
+    bool saved = false;
+
+    auto check_workload = [&](std::shared_ptr<const Workload> workload, const std::string& name) {
+        bool ok = true;
+        for (const std::string& algorithm : algorithms) {
+            std::string label = name + ", " + algorithm;
+            for (bool retire : {false, true}) {
+                runs++;
+                if (!check_run(workload, algorithm, time_slice, retire, label)) {
+                    failures++;
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    };
+
+    try {
+        if (!filename.empty()) {
+            check_workload(Workload::read_file(filename), filename);
+        } else {
+            for (uint64_t seed = first_seed; seed < first_seed + seeds; ++seed) {
+                auto workload = generate_workload(random_shape(seed, max_threads));
+                if (!check_workload(workload, "seed " + std::to_string(seed)) && !saved && !output.empty()) {
+                    std::ofstream file(output.c_str());
+                    workload->write(file);
+                    std::cout << "    workload written to " << output << std::endl;
+                    saved = true;
+                }
+            }
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << (runs - failures) << " of " << runs << " runs matched the reference engine." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
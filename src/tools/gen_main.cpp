@@ -0,0 +1,53 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "utilities/generator/generator.hpp"
+
+/*
+    cpu-sim-gen:
+        Writes a synthetic workload to a simulation file (standard output by default),
+        for use with cpu-sim or to keep as a test input. It takes the same key=value
+        options as cpu-sim --generate, which simulates the same workload without
+        writing it out, e.g.
+
+            cpu-sim-gen -o big.txt threads=1000000 seed=3 interarrival=exp:40 \
+                batch.weight=4 batch.cpu_burst=pareto:20:1.3 io_burst=lognormal:2:1
+
+        Usage: cpu-sim-gen [-o file] [key=value ...]
+*/
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    std::string filename = "";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc) {
+            filename = argv[++i];
+        } else if (!options.parse(argument)) {
+            std::cerr << "Usage: cpu-sim-gen [-o file] [key=value ...] (see cpu-sim --help, --generate)" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        auto workload = generate_workload(options);
+
+        if (filename.empty()) {
+            workload->write(std::cout);
+        } else {
+            std::ofstream output(filename.c_str());
+            if (!output) {
+                std::cerr << "Unable to open output file: " << filename << std::endl;
+                return 1;
+            }
+            workload->write(output);
+        }
+    } catch (...) {
+        // generate_workload has said what was wrong.
+        return 1;
+    }
+
+    return 0;
+}
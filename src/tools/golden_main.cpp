@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulation/simulation.hpp"
+#include "utilities/fmt/format.h"
+#include "types/workload/workload.hpp"
+
+/*
+    cpu-sim-golden:
+        Runs the golden-output regression tests in-process and in parallel: for every
+        tests/output/output-<algorithm>-<n>.<mode> file it simulates tests/input/input-<n>
+        with that algorithm and mode and compares the output, ignoring changes in the
+        amount of whitespace and blank lines (like diff -b -B). <algorithm> is an
+        algorithm name, optionally followed by -s<time slice> (e.g. rr-s6), and <mode>
+        is one of m, t and v.
+
+        Every case is run, and every failure is reported with the first line that
+        differs. Exits with status 1 if any case failed.
+
+        Usage: cpu-sim-golden [--tests dir] [--jobs N] [--verbose]
+*/
+
+namespace fs = std::filesystem;
+
+struct GoldenCase {
+    std::string name;
+    std::string input;
+    std::string expected_file;
+    FlagOptions flags;
+
+    bool passed = false;
+    std::string message;
+    double milliseconds = 0.0;
+};
+
+// Parses an expected output file name into a case. Returns false for other files.
+static bool parse_case(const fs::path& path, const fs::path& input_dir, GoldenCase& test) {
+    std::string name = path.filename().string();
+    const std::string prefix = "output-";
+
+    size_t dot = name.rfind('.');
+    size_t dash = name.rfind('-', dot);
+    if (name.compare(0, prefix.size(), prefix) != 0 || dot == std::string::npos || dash == std::string::npos || dash < prefix.size()) {
+        return false;
+    }
+
+    std::string algorithm = name.substr(prefix.size(), dash - prefix.size());
+    std::string number = name.substr(dash + 1, dot - dash - 1);
+    std::string mode = name.substr(dot + 1);
+    if (mode != "m" && mode != "t" && mode != "v") {
+        return false;
+    }
+
+    FlagOptions flags;
+    size_t slice = algorithm.find("-s");
+    if (slice != std::string::npos) {
+        flags.time_slice = std::stoi(algorithm.substr(slice + 2));
+        algorithm = algorithm.substr(0, slice);
+    }
+    std::transform(algorithm.begin(), algorithm.end(), algorithm.begin(), ::toupper);
+
+    flags.scheduler = algorithm;
+    flags.metrics = (mode == "m");
+    flags.per_thread = (mode == "t");
+    flags.verbose = (mode == "v");
+    flags.filename = (input_dir / ("input-" + number)).string();
+
+    test.name = name.substr(prefix.size());
+    test.input = flags.filename;
+    test.expected_file = path.string();
+    test.flags = flags;
+    return true;
+}
+
+// The lines of text with runs of whitespace collapsed, trailing whitespace removed
+// and blank lines dropped.
+static std::vector<std::string> normalize(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        std::string normal;
+        bool space = false;
+        for (char c : line) {
+            if (std::isspace((unsigned char) c)) {
+                space = true;
+            } else {
+                if (space) {
+                    normal += ' ';
+                }
+                normal += c;
+                space = false;
+            }
+        }
+        if (!normal.empty() && normal != " ") {
+            lines.push_back(normal);
+        }
+    }
+    return lines;
+}
+
+static std::string read_text(const std::string& filename) {
+    std::ifstream input(filename.c_str());
+    std::stringstream text;
+    text << input.rdbuf();
+    return text.str();
+}
+
+static void run_case(GoldenCase& test, const std::map<std::string, std::shared_ptr<const Workload>>& workloads) {
+    auto start = std::chrono::steady_clock::now();
+    std::ostringstream output;
+
+    try {
+        Simulation simulation(workloads.at(test.input), test.flags);
+        simulation.set_output(output);
+        simulation.run();
+
+        std::vector<std::string> actual = normalize(output.str());
+        std::vector<std::string> expected = normalize(read_text(test.expected_file));
+
+        size_t line = 0;
+        while (line < actual.size() && line < expected.size() && actual[line] == expected[line]) {
+            line++;
+        }
+
+        if (line == actual.size() && line == expected.size()) {
+            test.passed = true;
+        } else {
+            test.message = fmt::format("first difference at line {}:\n        expected: {}\n        actual:   {}", line + 1,
+                line < expected.size() ? expected[line] : "<end of output>",
+                line < actual.size() ? actual[line] : "<end of output>");
+        }
+    } catch (const std::exception& error) {
+        test.message = std::string("simulation failed: ") + error.what();
+    }
+
+    test.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    std::string tests_dir = "tests";
+    size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool verbose = false;
+
+    static struct option options[] = {
+        {"tests",   required_argument, 0, 'd'},
+        {"jobs",    required_argument, 0, 'j'},
+        {"verbose", no_argument,       0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    try {
+        int option;
+        while ((option = getopt_long(argc, argv, "d:j:v", options, nullptr)) != -1) {
+            switch (option) {
+                case 'd': tests_dir = optarg; break;
+                case 'j': jobs = std::max(1ull, std::stoull(optarg)); break;
+                case 'v': verbose = true; break;
+                default:
+                    std::cerr << "Usage: cpu-sim-golden [--tests dir] [--jobs N] [--verbose]" << std::endl;
+                    return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Bad option value." << std::endl;
+        return 1;
+    }
+
+    fs::path output_dir = fs::path(tests_dir) / "output";
+    fs::path input_dir = fs::path(tests_dir) / "input";
+    if (!fs::is_directory(output_dir)) {
+        std::cerr << "No such directory: " << output_dir.string() << std::endl;
+        return 1;
+    }
+
+    std::vector<GoldenCase> tests;
+    for (const auto& entry : fs::directory_iterator(output_dir)) {
+        GoldenCase test;
+        if (entry.is_regular_file() && parse_case(entry.path(), input_dir, test)) {
+            tests.push_back(test);
+        }
+    }
+    std::sort(tests.begin(), tests.end(), [](const GoldenCase& a, const GoldenCase& b) { return a.name < b.name; });
+
+    // Each input is read once and shared by all the cases using it.
+    std::map<std::string, std::shared_ptr<const Workload>> workloads;
+    for (const GoldenCase& test : tests) {
+        if (workloads.count(test.input) == 0 && fs::exists(test.input)) {
+            workloads[test.input] = Workload::read_file(test.input);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < tests.size(); i = next++) {
+            if (workloads.count(tests[i].input) == 0) {
+                tests[i].message = "missing input " + tests[i].input;
+                continue;
+            }
+            run_case(tests[i], workloads);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(jobs, tests.size()); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failures = 0;
+    for (const GoldenCase& test : tests) {
+        if (!test.passed) {
+            failures++;
+            std::printf("FAIL  %-24s %9.3f ms\n    %s\n", test.name.c_str(), test.milliseconds, test.message.c_str());
+        } else if (verbose) {
+            std::printf("pass  %-24s %9.3f ms\n", test.name.c_str(), test.milliseconds);
+        }
+    }
+
+    std::printf("%zu of %zu cases passed in %.3f ms (%zu jobs).\n", tests.size() - failures, tests.size(), total_ms, jobs);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "utilities/microbench/microbench.hpp"
+
+/*
+    cpu-sim-microbench:
+        Runs the microbenchmarks registered by the *_bench.cpp files and prints one CSV
+        row per measurement:
+
+            benchmark,depth,mean_depth,max_depth,ops,ns_per_op,allocations_per_op
+
+        The makefile builds it with -O2 -DNDEBUG; it says on stderr whether it was
+        optimized.
+
+        Usage: cpu-sim-microbench [--filter text] [--depths 16,1024,...] [--ops N]
+                                  [--time_slice N] [--seed N]
+*/
+
+int main(int argc, char** argv) {
+    MicrobenchOptions options;
+    std::string filter;
+
+    static struct option flag_options[] = {
+        {"filter",     required_argument, 0, 'f'},
+        {"depths",     required_argument, 0, 'd'},
+        {"ops",        required_argument, 0, 'n'},
+        {"time_slice", required_argument, 0, 's'},
+        {"seed",       required_argument, 0, 'r'},
+        {0, 0, 0, 0}
+    };
+
+    try {
+        int option;
+        while ((option = getopt_long(argc, argv, "f:d:n:s:r:", flag_options, nullptr)) != -1) {
+            switch (option) {
+                case 'f': filter = optarg; break;
+                case 'n': options.ops = std::stoull(optarg); break;
+                case 's': options.time_slice = std::stoi(optarg); break;
+                case 'r': options.seed = std::stoull(optarg); break;
+                case 'd': {
+                    options.depths.clear();
+                    std::stringstream stream(optarg);
+                    std::string depth;
+                    while (std::getline(stream, depth, ',')) {
+                        options.depths.push_back(std::stoull(depth));
+                    }
+                    break;
+                }
+                default:
+                    std::cerr << "Usage: cpu-sim-microbench [--filter text] [--depths 16,1024,...] [--ops N] "
+                                 "[--time_slice N] [--seed N]" << std::endl;
+                    return 1;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Bad option value." << std::endl;
+        return 1;
+    }
+
+    // On stderr, so the CSV is left as it is.
+#ifdef __OPTIMIZE__
+    std::cerr << "cpu-sim-microbench: optimized build" << std::endl;
+#else
+    std::cerr << "cpu-sim-microbench: unoptimized build, timings are not representative" << std::endl;
+#endif
+
+    std::cout << "benchmark,depth,mean_depth,max_depth,ops,ns_per_op,allocations_per_op" << std::endl;
+    for (const MicrobenchResult& result : run_microbenchmarks(options, filter)) {
+        std::printf("%s,%zu,%.1f,%zu,%zu,%.2f,%.4f\n", result.name.c_str(), result.depth, result.mean_depth,
+            result.max_depth, result.ops, result.ns_per_op, result.allocations_per_op);
+    }
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <fstream>
+#include <iostream>
+
+#include "utilities/logger/logger.hpp"
+#include "utilities/trace/trace.hpp"
+
+/*
+    cpu-sim-trace:
+        Turns a binary trace written with cpu-sim --trace back into the text that
+        cpu-sim --verbose prints for the same run.
+
+        Usage: cpu-sim-trace <trace file>
+*/
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: cpu-sim-trace <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "Unable to open trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    try {
+        decode_trace(input, Logger(true, false, false));
+    } catch (...) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -3,13 +3,13 @@
 #include <cassert>
 #include <stdexcept>
 
-Burst::Burst(BurstType type, int length)
+Burst::Burst(BurstType type, SimTime length)
 {
     burst_type = type;
     this->length = length;
 }
 
-void Burst::update_time(int delta_t)
+void Burst::update_time(SimTime delta_t)
 {
     length -= delta_t;
     if(length < 0){
@@ -2,6 +2,7 @@
 #define BURST_HPP
 
 #include "types/enums.hpp"
+#include "types/sim_time/sim_time.hpp"
 
 /*
     Burst:
@@ -24,9 +25,9 @@ public:
 
     /*
         length:
-            The length of the burst. Should be a positive integer.
+            The length of the burst. Should be positive.
     */
-    int length;
+    SimTime length;
 
     //==================================================
     //  Member functions
@@ -35,9 +36,9 @@ public:
     /*
         Burst(type, length):
             The constructor for a burst. Takes in a BurstType that denotes the type of burst
-            this will be, and an integer for the length.
+            this will be, and its length.
     */
-    Burst(BurstType type, int length);
+    Burst(BurstType type, SimTime length);
 
     
     /*
@@ -45,7 +46,7 @@ public:
             Update the burst time. This is useful when you have a preemptive algorithm so that
             the you can update a burst's remaining length after it has been preempted.
     */
-    void update_time(int delta_t);
+    void update_time(SimTime delta_t);
 };
 
 #endif
@@ -27,14 +27,23 @@ enum EventType {
     IO_BURST_COMPLETED,
     THREAD_COMPLETED,
     THREAD_PREEMPTED,
-    DISPATCHER_INVOKED
+    DISPATCHER_INVOKED,
+    NUM_EVENT_TYPES
+};
+
+enum DecisionReason {
+    NO_THREAD_READY,
+    RUN_TO_COMPLETION,
+    TIME_SLICE,
+    PRIORITY_QUEUE
 };
 
 enum ProcessPriority {
     SYSTEM,
     INTERACTIVE,
     NORMAL,
-    BATCH
+    BATCH,
+    NUM_PROCESS_PRIORITIES
 };
 
 enum ThreadState {
@@ -42,7 +51,44 @@ enum ThreadState {
     READY,
     RUNNING,
     BLOCKED,
-    EXIT
+    EXIT,
+    NUM_THREAD_STATES
+};
+
+/*
+    The names of the event types, priorities and thread states as they are printed,
+    indexed by value. Each NUM_ value above is the number of values of its enum, so
+    a value added without a name fails to compile.
+*/
+
+inline const char* const EVENT_TYPE_NAMES[] = {
+    "THREAD_ARRIVED",
+    "THREAD_DISPATCH_COMPLETED",
+    "PROCESS_DISPATCH_COMPLETED",
+    "CPU_BURST_COMPLETED",
+    "IO_BURST_COMPLETED",
+    "THREAD_COMPLETED",
+    "THREAD_PREEMPTED",
+    "DISPATCHER_INVOKED"
+};
+
+inline const char* const PROCESS_PRIORITY_NAMES[] = {
+    "SYSTEM",
+    "INTERACTIVE",
+    "NORMAL",
+    "BATCH"
 };
 
+inline const char* const THREAD_STATE_NAMES[] = {
+    "NEW",
+    "READY",
+    "RUNNING",
+    "BLOCKED",
+    "EXIT"
+};
+
+static_assert(sizeof(EVENT_TYPE_NAMES) / sizeof(EVENT_TYPE_NAMES[0]) == NUM_EVENT_TYPES, "an event type has no name");
+static_assert(sizeof(PROCESS_PRIORITY_NAMES) / sizeof(PROCESS_PRIORITY_NAMES[0]) == NUM_PROCESS_PRIORITIES, "a priority has no name");
+static_assert(sizeof(THREAD_STATE_NAMES) / sizeof(THREAD_STATE_NAMES[0]) == NUM_THREAD_STATES, "a thread state has no name");
+
 #endif
@@ -1,17 +1,26 @@
 #ifndef EVENT_HPP
 #define EVENT_HPP
 
+#include <cstdint>
 #include <memory>
 #include <iostream>
 #include <vector>
 
 #include "types/scheduling_decision/scheduling_decision.hpp"
+#include "types/sim_time/sim_time.hpp"
 #include "types/thread/thread.hpp"
 #include "types/enums.hpp"
 
 /*
     Event:
         A class that encapsulates a single event.
+
+        Events are small values: they refer to their thread by a plain (non-owning)
+        pointer and carry a copy of the scheduling decision, so the event queue can
+        store them directly without allocating each one.
+
+        The queue's sort key, (time, event_num), is the first 16 bytes of an event,
+        so comparing two events reads a single cache line of each.
 */
 
 class Event {
@@ -21,19 +30,11 @@ public:
     //  Member variables
     //==================================================
 
-    /*
-        type:
-            The type of event this is, i.e., THREAD_ARRIVED, DISPATCHER_INVOKED, etc. Should be
-            an EventType, an enum defined in "types/enums.hpp".
-    */
-
-    EventType type;
-
     /*
         time:
-            The scheduled time that the event will occur. Should be an unsigned integer.
+            The scheduled time that the event will occur. Never negative.
     */
-    unsigned int time;
+    SimTime time;
 
     /*
         event_num:
@@ -41,21 +42,30 @@ public:
             event should have a number of 1, and so on. This value is used in the case of
             tie breaks for the event queue (see below).
     */
-    unsigned int event_num;
+    uint64_t event_num;
+
+    /*
+        type:
+            The type of event this is, i.e., THREAD_ARRIVED, DISPATCHER_INVOKED, etc. Should be
+            an EventType, an enum defined in "types/enums.hpp".
+    */
+
+    EventType type;
 
     /*
         thread:
             The thread associated with the event. If this event does not need a thread,
-            then we can set this equal to nullptr.
+            then we can set this equal to nullptr. The event does not own the thread.
     */
-    std::shared_ptr<Thread> thread;
+    Thread* thread;
 
     /*
         scheduling_decision:
             The associated scheduling decision for this event. We may get set this when we create
-            a new event within Simulation::handle_dispatcher_invoked(event).
+            a new event within Simulation::handle_dispatcher_invoked(event). Events that are not
+            the result of a scheduling decision hold a default (empty) one.
     */
-    std::shared_ptr<SchedulingDecision> scheduling_decision;
+    SchedulingDecision scheduling_decision;
 
     //==================================================
     //  Member functions
@@ -63,19 +73,19 @@ public:
 
     /*
         Event():
-            The class constructor. Takes in an EventType representing the type of event it should be,
-            a time representing when this event is scheduled to occur, an integer indicating which event this is,
-            a Thread if one is associated with this event (or nullptr if one is not), and a SchedulingDecision if
-            one is associated with this event (or nullptr if one is not).
+            An empty placeholder event, to be assigned a real one.
     */
-    Event(EventType type, unsigned int time, unsigned int event_num, std::shared_ptr<Thread> thread, std::shared_ptr<SchedulingDecision> sd):
-        type(type), time(time), event_num(event_num), thread(thread), scheduling_decision(sd) {}
+    Event() : time(0), event_num(0), type(THREAD_ARRIVED), thread(nullptr) {}
 
     /*
-        ~Event():
-            The class destructor.
+        Event(type, time, event_num, thread, sd):
+            The class constructor. Takes in an EventType representing the type of event it should be,
+            a time representing when this event is scheduled to occur, an integer indicating which event this is,
+            a Thread if one is associated with this event (or nullptr if one is not), and a SchedulingDecision if
+            one is associated with this event (or an empty decision if one is not).
     */
-    ~Event() {}
+    Event(EventType type, SimTime time, uint64_t event_num, Thread* thread, const SchedulingDecision& sd = SchedulingDecision()):
+        time(time), event_num(event_num), type(type), thread(thread), scheduling_decision(sd) {}
 };
 
 struct EventComparator{
@@ -93,12 +103,12 @@ struct EventComparator{
 
             We use > (greater than) as the comparison so that the smaller elements will rise to the top, which is what we want.
         */
-    bool operator()(const std::shared_ptr<Event> event_1, const std::shared_ptr<Event> event_2) {
-        if(event_1->time == event_2->time) {
-            return event_1->event_num > event_2->event_num;
+    bool operator()(const Event& event_1, const Event& event_2) const {
+        if(event_1.time == event_2.time) {
+            return event_1.event_num > event_2.event_num;
         }
         else {
-            return event_1->time > event_2->time;
+            return event_1.time > event_2.time;
         }
     }
 };
@@ -0,0 +1,60 @@
+#include "types/histogram/histogram.hpp"
+
+#include <cmath>
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return (size_t) value;
+    }
+
+    // Position of the highest set bit, at least SUB_BUCKET_BITS here.
+    int exponent = 63 - __builtin_clzll(value);
+    int shift = exponent - (SUB_BUCKET_BITS - 1);
+    size_t sub_bucket = (size_t) (value >> shift) - HALF_SUB_BUCKETS;
+
+    return SUB_BUCKETS + (size_t) (exponent - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    size_t octave = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS;
+    size_t sub_bucket = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS;
+    int shift = (int) octave + 1;
+
+    uint64_t lower = (uint64_t) (HALF_SUB_BUCKETS + sub_bucket) << shift;
+    return lower + (((uint64_t) 1 << shift) - 1);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    if (other.min_value < min_value) { min_value = other.min_value; }
+    if (other.max_value > max_value) { max_value = other.max_value; }
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // The rank of the value we are looking for, between 1 and count.
+    uint64_t rank = (uint64_t) std::ceil(p / 100.0 * count);
+    if (rank < 1) { rank = 1; }
+    if (rank > count) { rank = count; }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper_bound(i);
+            return upper < max_value ? upper : max_value;
+        }
+    }
+    return max_value;
+}
@@ -0,0 +1,107 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+    LatencyHistogram:
+        A log-bucketed histogram of non-negative integer values (in the style of
+        HdrHistogram), used to report latency percentiles without keeping every sample.
+
+        Values below 2^SUB_BUCKET_BITS are counted exactly. Above that, every power of
+        two range [2^e, 2^(e+1)) is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so
+        a reported value is always within 1/2^(SUB_BUCKET_BITS - 1) (about 3%) of the
+        true one. The whole 64-bit range fits in a fixed array, so recording is O(1),
+        memory is constant, and two histograms can be merged by adding their counts.
+*/
+
+class LatencyHistogram {
+public:
+
+    //==================================================
+    //  Constants
+    //==================================================
+
+    static const int SUB_BUCKET_BITS = 6;
+    static const size_t SUB_BUCKETS = (size_t) 1 << SUB_BUCKET_BITS;
+    static const size_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static const size_t NUM_BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        record(value):
+            Counts one occurrence of value. Negative values are counted as 0.
+    */
+    void record(int64_t value) {
+        uint64_t v = value < 0 ? 0 : (uint64_t) value;
+        buckets[bucket_index(v)]++;
+        count++;
+        sum += v;
+        if (v < min_value) { min_value = v; }
+        if (v > max_value) { max_value = v; }
+    }
+
+    /*
+        merge(other):
+            Adds all the values recorded in other to this histogram.
+    */
+    void merge(const LatencyHistogram& other);
+
+    /*
+        percentile(p):
+            Returns the value below or at which p percent of the recorded values fall
+            (p in [0, 100]), rounded up to the top of its bucket but never above the
+            largest recorded value. Returns 0 if nothing has been recorded.
+    */
+    uint64_t percentile(double p) const;
+
+    /*
+        total_count():
+            The number of recorded values.
+    */
+    uint64_t total_count() const { return count; }
+
+    /*
+        max(), min():
+            The largest and smallest recorded values (0 if nothing was recorded).
+    */
+    uint64_t max() const { return max_value; }
+
+    uint64_t min() const { return count == 0 ? 0 : min_value; }
+
+    /*
+        mean():
+            The average of the recorded values (0 if nothing was recorded).
+    */
+    double mean() const { return count == 0 ? 0.0 : (double) sum / count; }
+
+    /*
+        bucket_index(value):
+            The index of the bucket value is counted in.
+    */
+    static size_t bucket_index(uint64_t value);
+
+    /*
+        bucket_upper_bound(index):
+            The largest value that is counted in the given bucket.
+    */
+    static uint64_t bucket_upper_bound(size_t index);
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    uint64_t buckets[NUM_BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+};
+
+#endif
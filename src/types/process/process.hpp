@@ -1,7 +1,7 @@
 #ifndef PROCESS_HPP
 #define PROCESS_HPP
 
-#include <memory>
+#include <memory_resource>
 #include <vector>
 
 #include "types/enums.hpp"
@@ -36,20 +36,23 @@ public:
 
     /*
         threads:
-            A vector of the process's threads.
+            A vector of the process's threads. The threads (and the vector's storage) are
+            allocated from the memory resource given to the constructor.
     */
-    std::vector<std::shared_ptr<Thread>> threads;
+    std::pmr::vector<Thread*> threads;
 
     //==================================================
     //  Member functions
     //==================================================
 
     /*
-        Process(pid, priority):
+        Process(pid, priority, memory):
             A constructor for a new process object. We give it a process ID and priority,
-            and a new process with that information is create.
+            and a new process with that information is create. The threads vector allocates
+            from `memory` (normally the simulation's arena).
     */
-    Process(int pid, ProcessPriority priority) : process_id(pid), priority(priority) {}
+    Process(int pid, ProcessPriority priority, std::pmr::memory_resource* memory = std::pmr::get_default_resource()) :
+        process_id(pid), priority(priority), threads(memory) {}
 };
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef RUN_INFO_HPP
+#define RUN_INFO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "utilities/flags/flags.hpp"
+
+/*
+    RunInfo:
+        Describes a simulation run rather than the simulated system: the configuration
+        it ran with, the size of the workload and how much work the simulator itself
+        did. Reported next to the SystemStats in machine-readable output.
+*/
+
+class RunInfo {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        filename:
+            The simulation file the workload was read from.
+    */
+    std::string filename;
+
+    /*
+        algorithm, time_slice:
+            The scheduling algorithm and the time slice it used (-1 if none).
+    */
+    std::string algorithm;
+    int time_slice = -1;
+
+    /*
+        options:
+            The options the run was simulated with. The report lists the ones that
+            change its results, so that it can be reproduced.
+    */
+    FlagOptions options;
+
+    /*
+        num_processes, num_threads:
+            The size of the workload.
+    */
+    size_t num_processes = 0;
+    size_t num_threads = 0;
+
+    /*
+        events_processed:
+            The number of events handled by the event loop.
+    */
+    uint64_t events_processed = 0;
+
+    /*
+        stop_reason:
+            Why the run ended before running out of events: "max_time", "max_events",
+            "max_completed", "converged" or, for an open system, "duration". Empty if
+            it ran to completion.
+    */
+    std::string stop_reason;
+
+    /*
+        wall_time_ns:
+            How long the event loop took, in nanoseconds of wall-clock time.
+    */
+    uint64_t wall_time_ns = 0;
+
+    /*
+        event_loop_allocations:
+            The number of heap allocations made while the event loop was executing
+            (see utilities/memory/allocation_counter.hpp). Once the arena and the ready
+            queues have grown to the size of the workload this stays at zero, no matter
+            how many events are processed.
+    */
+    size_t event_loop_allocations = 0;
+
+    /*
+        arena_bytes:
+            The memory reserved by the simulation arena at the end of the run.
+    */
+    size_t arena_bytes = 0;
+};
+
+#endif
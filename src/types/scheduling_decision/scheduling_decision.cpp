@@ -0,0 +1,30 @@
+#include "types/scheduling_decision/scheduling_decision.hpp"
+
+#include "types/enums.hpp"
+
+#include "utilities/fmt/format.h"
+
+static std::string format_queue_sizes(const unsigned int sizes[4]) {
+    return fmt::format("[S: {} I: {} N: {} B: {}]", sizes[0], sizes[1], sizes[2], sizes[3]);
+}
+
+std::string SchedulingDecision::explanation() const {
+    switch (reason) {
+        case RUN_TO_COMPLETION:
+            return fmt::format("Selected from {} threads. Will run to completion of burst.", queue_sizes[0]);
+
+        case TIME_SLICE:
+            return fmt::format("Selected from {} threads. Will run for at most {} ticks.", queue_sizes[0], time_slice);
+
+        case PRIORITY_QUEUE: {
+            unsigned int after[4] = {queue_sizes[0], queue_sizes[1], queue_sizes[2], queue_sizes[3]};
+            after[queue]--;
+            return fmt::format("Selected from {} queue. {} -> {}", PROCESS_PRIORITY_NAMES[queue],
+                format_queue_sizes(queue_sizes), format_queue_sizes(after));
+        }
+
+        case NO_THREAD_READY:
+            break;
+    }
+    return "";
+}
@@ -1,14 +1,20 @@
 #ifndef SCHEDULING_DECISION_HPP
 #define SCHEDULING_DECISION_HPP
 
-#include <memory>
+#include <string>
 
+#include "types/enums.hpp"
 #include "types/thread/thread.hpp"
 
 /*
     SchedulingDecision:
         A class for a scheduling decision. This is what your
         algorithm should return.
+
+        It is a small plain value (no heap-allocated members), so schedulers return it
+        by value and events carry copies of it. The human-readable explanation is not
+        stored; it is rebuilt from the reason and the queue sizes by explanation(),
+        which is only called when it is actually going to be printed.
 */
 
 class SchedulingDecision {
@@ -20,16 +26,10 @@ public:
 
     /*
         thread:
-            A thread. The next thread to run,
-    */
-    std::shared_ptr<Thread> thread = nullptr;
-    
-    /*
-        explanation:
-            A string containing an explanation of the scheduling decision. See
-            the Scheduler class for an example of what this should be.
+            A thread. The next thread to run, or nullptr if no thread was ready.
+            This does not own the thread.
     */
-    std::string explanation;
+    Thread* thread = nullptr;
 
     /*
         time_slice:
@@ -37,7 +37,37 @@ public:
             should not be preempted.
     */
     int time_slice = -1;
-    
+
+    /*
+        reason:
+            Why this thread was chosen. Determines how explanation() words the decision.
+    */
+    DecisionReason reason = NO_THREAD_READY;
+
+    /*
+        queue:
+            For schedulers with several ready queues, the index of the queue the
+            thread was taken from. 0 for single-queue schedulers.
+    */
+    int queue = 0;
+
+    /*
+        queue_sizes:
+            The sizes of the scheduler's ready queues just before the thread was taken.
+            Single-queue schedulers only use the first entry.
+    */
+    unsigned int queue_sizes[4] = {0, 0, 0, 0};
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        explanation():
+            Returns a message explaining the decision. See the Scheduler class for
+            an example of what this looks like.
+    */
+    std::string explanation() const;
 };
 
 #endif
@@ -0,0 +1,26 @@
+#ifndef SIM_TIME_HPP
+#define SIM_TIME_HPP
+
+#include <cstdint>
+
+/*
+    SimTime:
+        A point in or a length of simulated time, in ticks. Every time in the engine
+        (events, threads, bursts, statistics and run limits) has this one type, so a
+        run can be as long as 2^63 - 1 ticks: a day at microsecond granularity is only
+        8.64e10 of them. Workloads whose times could go past that are rejected when
+        they are loaded, so the simulation itself never has to check.
+*/
+using SimTime = int64_t;
+
+static const SimTime SIM_TIME_MAX = INT64_MAX;
+
+/*
+    add_time(a, b, sum):
+        Sets sum to a + b. Returns false if that overflows SimTime.
+*/
+inline bool add_time(SimTime a, SimTime b, SimTime& sum) {
+    return !__builtin_add_overflow(a, b, &sum);
+}
+
+#endif
@@ -1,10 +1,20 @@
 #ifndef SYSTEM_STATS_HPP
 #define SYSTEM_STATS_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+#include "types/histogram/histogram.hpp"
+#include "types/sim_time/sim_time.hpp"
+
 /*
     SystemStats:
         A simple class for encapsulating the statistics that
         you are required to record for the simulation.
+
+        The counters and totals are updated while the simulation runs (as each thread
+        exits), so only the derived values (averages, idle time, percentages) have to be
+        computed once the event loop is done.
 */
 
 class SystemStats {
@@ -18,37 +28,37 @@ public:
         total_time:
             The total amount of time that has elapsed in the simulation.
     */
-    size_t total_time = 0;
+    SimTime total_time = 0;
 
     /*
         total_idle_time:
             The amount of time that the processor has been idle.
     */
-    size_t total_idle_time = 0;
+    SimTime total_idle_time = 0;
 
     /*
         dispatch_time:
             The amount of time that the processor has spent dispatching (overhead).
     */
-    size_t dispatch_time = 0;
+    SimTime dispatch_time = 0;
 
     /*
         service_time:
             The amount of time that the processor has spent executing threads.
     */
-    size_t service_time = 0;
+    SimTime service_time = 0;
 
     /*
         io_time:
             The cumulative amount of time that all threads have spent doing IO.
     */
-    size_t io_time = 0;
+    SimTime io_time = 0;
 
     /*
         total_cpu_time:
             The amount of time that the processor was in use.
     */
-    size_t total_cpu_time = 0;
+    SimTime total_cpu_time = 0;
 
     /*
         cpu_utilization:
@@ -79,6 +89,63 @@ public:
             The average turnaround time for threads of different priorities.
     */
     double avg_thread_turnaround_times[4] = {0.0, 0.0, 0.0, 0.0};
+
+    /*
+        total_thread_response_times[4]:
+            The sum of the response times of the exited threads of each priority.
+    */
+    uint64_t total_thread_response_times[4] = {0, 0, 0, 0};
+
+    /*
+        total_thread_turnaround_times[4]:
+            The sum of the turnaround times of the exited threads of each priority.
+    */
+    uint64_t total_thread_turnaround_times[4] = {0, 0, 0, 0};
+
+    /*
+        response_time_histograms[4]:
+            The distribution of thread response times, per priority.
+    */
+    LatencyHistogram response_time_histograms[4];
+
+    /*
+        turnaround_time_histograms[4]:
+            The distribution of thread turnaround times, per priority.
+    */
+    LatencyHistogram turnaround_time_histograms[4];
+
+    /*
+        ready_wait_histograms[4]:
+            The distribution of the time a thread sat in the ready queue before the
+            dispatcher picked it, one sample per pick, per priority.
+    */
+    LatencyHistogram ready_wait_histograms[4];
+
+    /*
+        burst_wait_histograms[4]:
+            The distribution of the total time each CPU burst spent waiting (ready or
+            being dispatched, over all its preemptions) rather than running, one sample
+            per completed CPU burst, per priority.
+    */
+    LatencyHistogram burst_wait_histograms[4];
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        merge_histograms(other):
+            Adds the latency histograms of another run (e.g. another configuration of
+            a sweep) to this one's.
+    */
+    void merge_histograms(const SystemStats& other) {
+        for (int i = 0; i < 4; ++i) {
+            response_time_histograms[i].merge(other.response_time_histograms[i]);
+            turnaround_time_histograms[i].merge(other.turnaround_time_histograms[i]);
+            ready_wait_histograms[i].merge(other.ready_wait_histograms[i]);
+            burst_wait_histograms[i].merge(other.burst_wait_histograms[i]);
+        }
+    }
 };
 
 #endif
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "types/thread/thread.hpp"
 
-void Thread::set_ready(int time) {
+void Thread::set_ready(SimTime time) {
     if(current_state == NEW || current_state == BLOCKED || current_state == RUNNING){
         set_state(READY, time);
     }
@@ -13,7 +13,7 @@ void Thread::set_ready(int time) {
     }
 }
 
-void Thread::set_running(int time) {
+void Thread::set_running(SimTime time) {
     if(current_state == READY){
         set_state(RUNNING, time);
     }
@@ -23,7 +23,7 @@ void Thread::set_running(int time) {
     }
 }
 
-void Thread::set_blocked(int time) {
+void Thread::set_blocked(SimTime time) {
     if(current_state == READY || current_state == RUNNING){
         set_state(BLOCKED, time);
     }
@@ -33,7 +33,7 @@ void Thread::set_blocked(int time) {
     }
 }
 
-void Thread::set_finished(int time) {
+void Thread::set_finished(SimTime time) {
     if(current_state == RUNNING){
         set_state(EXIT, time);
     }
@@ -43,54 +43,31 @@ void Thread::set_finished(int time) {
     }
 }
 
-int Thread::response_time() const {
+SimTime Thread::response_time() const {
     return start_time - arrival_time;
 }
 
-int Thread::turnaround_time() const {
+SimTime Thread::turnaround_time() const {
     return end_time - arrival_time;
 }
 
-void Thread::set_state(ThreadState state, int time) {
+void Thread::set_state(ThreadState state, SimTime time) {
     state_change_time = time;
     previous_state = current_state;
     current_state = state;
 }
 
-std::shared_ptr<Burst> Thread::get_next_burst(BurstType type) {
-    int num_bursts = bursts.size();
-    int i = 0;
-    while(i != num_bursts){
-        if(bursts.front()->burst_type == type){
-            return bursts.front();
-        }
-        else{
-            std::shared_ptr<Burst> b = bursts.front();
-            bursts.pop();
-            bursts.push(b);
-            i++;
-        }
+Burst* Thread::get_next_burst(BurstType type) {
+    if(next_burst == num_bursts || bursts[next_burst].burst_type != type){
+        return nullptr;
     }
-    //if cant find burst of correct type, return nullptr
-    return nullptr;
-
+    return &bursts[next_burst];
 }
 
-std::shared_ptr<Burst> Thread::pop_next_burst(BurstType type) {
-    int num_bursts = bursts.size();
-    int i = 0;
-    while(i != num_bursts){
-        if(bursts.front()->burst_type == type){
-            std::shared_ptr<Burst> b = bursts.front();
-            bursts.pop();
-            return b;
-        }
-        else{
-            std::shared_ptr<Burst> b = bursts.front();
-            bursts.pop();
-            bursts.push(b);
-            i++;
-        }
+Burst* Thread::pop_next_burst(BurstType type) {
+    Burst* b = get_next_burst(type);
+    if(b != nullptr){
+        next_burst++;
     }
-    return nullptr;
-}
\ No newline at end of file
+    return b;
+}
@@ -1,13 +1,13 @@
 #ifndef THREAD_HPP
 #define THREAD_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <memory>
-#include <vector>
-#include <queue>
 
 #include "types/burst/burst.hpp"
 #include "types/enums.hpp"
+#include "types/sim_time/sim_time.hpp"
 
 /*
     Thread:
@@ -36,43 +36,57 @@ public:
     */
     int process_id = -1;
 
+    /*
+        handle:
+            The index of the thread in the workload (Workload::threads), which
+            identifies it in traces.
+    */
+    uint32_t handle = 0;
+
     /*
         arrival_time:
             When the thread arrived into the simulation. Taken from the input file.
     */
-    int arrival_time = -1;
+    SimTime arrival_time = -1;
 
     /*
         start_time:
             The time the CPU was first able to execute this thread. Should be set when
             the thread transitions from NEW to RUNNING.
     */
-    int start_time = -1;
+    SimTime start_time = -1;
 
     /*
         end_time:
             The time that all of this thread's CPU and IO bursts were completed.
             Set when the thread transitions from RUNNING to EXIT.
     */
-    int end_time = -1;
+    SimTime end_time = -1;
 
     /*
         service_time:
             The service time for the thread. The total time it was spent on the CPU.
     */
-    int service_time = 0;
+    SimTime service_time = 0;
 
     /*
         io_time:
             The IO time for the thread. The total time it spent in IO.
     */
-    int io_time = 0;
+    SimTime io_time = 0;
+
+    /*
+        burst_wait_time:
+            How long the current CPU burst has waited (ready or being dispatched) so far,
+            summed over its preemptions. Reset when the burst completes.
+    */
+    SimTime burst_wait_time = 0;
 
     /*
         state_change_time:
             The time of the last state change.
     */
-    int state_change_time = -1;
+    SimTime state_change_time = -1;
 
     /*
         priority:
@@ -94,10 +108,23 @@ public:
 
     /*
         bursts:
-            A queue of bursts. Should contain the CPU and IO bursts in the correct order as
-            specified in the simulation file.
+            An array of bursts. Should contain the CPU and IO bursts in the correct order as
+            specified in the simulation file. The array is not owned by the thread; it lives
+            in the simulation's arena alongside the thread.
     */
-    std::queue<std::shared_ptr<Burst>> bursts;
+    Burst* bursts = nullptr;
+
+    /*
+        num_bursts:
+            The number of bursts in the bursts array.
+    */
+    size_t num_bursts = 0;
+
+    /*
+        next_burst:
+            The index of the next burst to run. Bursts before it have been completed.
+    */
+    size_t next_burst = 0;
 
     //==================================================
     //  Member functions
@@ -108,7 +135,7 @@ public:
             A constuctor for a thread object. We give it an arrival time, thread ID,
             process ID, and priority, and a thread with those variables is constructed.
     */
-    Thread(int arrival, int thread_id, int process_id, ProcessPriority priority):
+    Thread(SimTime arrival, int thread_id, int process_id, ProcessPriority priority):
         arrival_time(arrival), thread_id(thread_id), process_id(process_id), priority(priority) {}
 
     /*
@@ -118,42 +145,48 @@ public:
             to make sure that the transition is valid, e.g., is NEW->BLOCKED a valid transition?
             Throwing an exception for an invalid transition may be a good idea.
     */
-    void set_ready(int time);
+    void set_ready(SimTime time);
 
-    void set_running(int time);
+    void set_running(SimTime time);
 
-    void set_blocked(int time);
+    void set_blocked(SimTime time);
 
-    void set_finished(int time);
+    void set_finished(SimTime time);
 
-    void set_state(ThreadState state, int time);
+    void set_state(ThreadState state, SimTime time);
 
     /*
         response_time():
             Calculate the response time for this particular thread.
     */
-    int response_time() const;
+    SimTime response_time() const;
 
     /*
         turnaround_time():
             Calculate the turnaround time for this particular thread.
     */
-    int turnaround_time() const;
+    SimTime turnaround_time() const;
 
     /*
         get_next_burst(type):
-            Get the next burst. We should ensure that the next burst in the queue
-            is of the appropriate type.
+            Get the next burst. Returns nullptr if there are no bursts left or the next
+            burst is not of the requested type.
     */
-    std::shared_ptr<Burst> get_next_burst(BurstType type);
+    Burst* get_next_burst(BurstType type);
 
 
     /*
         pop_next_burst(type):
-            Pop the next burst. We should ensure that the next burst in the queue
-            is of the appropriate type.
+            Pop the next burst, returning it. Returns nullptr (and pops nothing) if there
+            are no bursts left or the next burst is not of the requested type.
+    */
+    Burst* pop_next_burst(BurstType type);
+
+    /*
+        bursts_remaining():
+            The number of bursts that have not been popped yet.
     */
-    std::shared_ptr<Burst> pop_next_burst(BurstType type);
+    size_t bursts_remaining() const { return num_bursts - next_burst; }
 
 };
 
@@ -0,0 +1,165 @@
+#include "types/workload/workload.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+std::shared_ptr<const Workload> Workload::read_file(const std::string& filename) {
+    std::ifstream input_file(filename.c_str());
+
+    if (!input_file) {
+        std::cerr << "Unable to open simulation file: " << filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+
+    return read(input_file);
+}
+
+std::shared_ptr<const Workload> Workload::read(std::istream& input) {
+    auto workload = std::make_shared<Workload>();
+
+    int num_processes;
+
+    input >> num_processes >> workload->thread_switch_overhead >> workload->process_switch_overhead;
+
+    for (int proc = 0; proc < num_processes; ++proc) {
+        workload->read_process(input);
+    }
+
+    if (input.fail()) {
+        std::cerr << "The simulation file is malformed or has a value out of range." << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+
+    workload->check_times();
+    workload->sort_arrivals();
+
+    return workload;
+}
+
+void Workload::read_process(std::istream& input) {
+    int process_id, priority;
+    int num_threads;
+
+    input >> process_id >> priority >> num_threads;
+
+    ProcessSpec process;
+    process.process_id = process_id;
+    process.priority = (ProcessPriority) priority;
+    process.first_thread = this->threads.size();
+    process.num_threads = num_threads;
+
+    // iterate over the threads
+    for (int thread_id = 0; thread_id < num_threads; ++thread_id) {
+        read_thread(input, thread_id, process_id, (ProcessPriority) priority);
+    }
+
+    this->processes.push_back(process);
+}
+
+void Workload::read_thread(std::istream& input, int thread_id, int process_id, ProcessPriority priority) {
+    SimTime arrival_time;
+    int num_cpu_bursts;
+
+    input >> arrival_time >> num_cpu_bursts;
+
+    ThreadSpec thread;
+    thread.thread_id = thread_id;
+    thread.process_id = process_id;
+    thread.priority = priority;
+    thread.process_index = this->processes.size();
+    thread.arrival_time = arrival_time;
+    thread.first_burst = this->bursts.size();
+    thread.num_bursts = num_cpu_bursts > 0 ? num_cpu_bursts * 2 - 1 : 0;
+
+    for (int n = 0; n < (int) thread.num_bursts; ++n) {
+        SimTime burst_length;
+        input >> burst_length;
+
+        BurstType burst_type = (n % 2 == 0) ? BurstType::CPU : BurstType::IO;
+
+        this->bursts.emplace_back(burst_type, burst_length);
+    }
+
+    this->threads.push_back(thread);
+}
+
+void Workload::write(std::ostream& output) const {
+    // Built up in a buffer and written in large chunks: workloads can be huge.
+    std::string buffer;
+    auto flush = [&]() {
+        output.write(buffer.data(), buffer.size());
+        buffer.clear();
+    };
+
+    buffer += std::to_string(this->processes.size()) + " " + std::to_string(this->thread_switch_overhead)
+        + " " + std::to_string(this->process_switch_overhead) + "\n";
+
+    for (const ProcessSpec& process : this->processes) {
+        buffer += "\n" + std::to_string(process.process_id) + " " + std::to_string((int) process.priority)
+            + " " + std::to_string(process.num_threads) + "\n";
+
+        for (size_t t = process.first_thread; t < process.first_thread + process.num_threads; ++t) {
+            const ThreadSpec& thread = this->threads[t];
+
+            buffer += std::to_string(thread.arrival_time) + " " + std::to_string((thread.num_bursts + 1) / 2) + "\n";
+            for (size_t b = 0; b < thread.num_bursts; ++b) {
+                buffer += std::to_string(this->bursts[thread.first_burst + b].length);
+                buffer += (b % 2 == 0 && b + 1 < thread.num_bursts) ? " " : "\n";
+            }
+        }
+
+        if (buffer.size() >= (1 << 16)) {
+            flush();
+        }
+    }
+    flush();
+}
+
+void Workload::check_times() const {
+    // Once the last thread has arrived, until every thread has exited, the CPU is
+    // always running or dispatching a thread, or some thread is doing IO. Each CPU
+    // burst is dispatched at most once per tick of it (plus once if it is empty).
+    SimTime overhead = std::max(this->thread_switch_overhead, this->process_switch_overhead);
+    bool negative = this->thread_switch_overhead < 0 || this->process_switch_overhead < 0;
+    bool fits = true;
+    SimTime end = 0;
+
+    for (const ThreadSpec& thread : this->threads) {
+        negative = negative || thread.arrival_time < 0;
+        end = std::max(end, thread.arrival_time);
+    }
+
+    for (const Burst& burst : this->bursts) {
+        negative = negative || burst.length < 0;
+        SimTime dispatches = burst.burst_type == CPU ? std::max<SimTime>(burst.length, 1) : 0;
+        SimTime dispatch_time;
+        fits = fits && !__builtin_mul_overflow(dispatches, overhead, &dispatch_time)
+            && add_time(end, burst.length, end) && add_time(end, dispatch_time, end);
+    }
+
+    if (negative) {
+        std::cerr << "Simulation times and overheads cannot be negative." << std::endl;
+        throw(std::logic_error("Bad workload."));
+    }
+    if (!fits) {
+        std::cerr << "The workload's times could overflow the simulation's time type (at most "
+            << SIM_TIME_MAX << " ticks)." << std::endl;
+        throw(std::logic_error("Bad workload."));
+    }
+}
+
+void Workload::sort_arrivals() {
+    if (this->threads.size() > UINT32_MAX) {
+        throw(std::logic_error("Too many threads."));
+    }
+
+    this->arrival_order.resize(this->threads.size());
+    for (size_t i = 0; i < this->threads.size(); ++i) {
+        this->arrival_order[i] = (uint32_t) i;
+    }
+
+    std::stable_sort(this->arrival_order.begin(), this->arrival_order.end(), [this](uint32_t a, uint32_t b) {
+        return this->threads[a].arrival_time < this->threads[b].arrival_time;
+    });
+}
@@ -0,0 +1,205 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types/burst/burst.hpp"
+#include "types/enums.hpp"
+#include "types/sim_time/sim_time.hpp"
+
+/*
+    ThreadSpec:
+        The description of a thread as given in the simulation file: who it belongs to,
+        when it arrives and which bursts it runs. It never changes during a simulation;
+        the mutable state of a thread in a particular run lives in a Thread object.
+*/
+
+class ThreadSpec {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        thread_id:
+            The thread's ID within its process.
+    */
+    int thread_id = -1;
+
+    /*
+        process_id:
+            The ID of the thread's parent process.
+    */
+    int process_id = -1;
+
+    /*
+        priority:
+            The priority of the parent process.
+    */
+    ProcessPriority priority = SYSTEM;
+
+    /*
+        process_index:
+            The index of the parent process in Workload::processes.
+    */
+    size_t process_index = 0;
+
+    /*
+        arrival_time:
+            When the thread arrives into the simulation.
+    */
+    SimTime arrival_time = 0;
+
+    /*
+        first_burst, num_bursts:
+            The thread's bursts are Workload::bursts[first_burst, first_burst + num_bursts).
+            They alternate CPU, IO, CPU, ... and always start and end with a CPU burst.
+    */
+    size_t first_burst = 0;
+    size_t num_bursts = 0;
+};
+
+/*
+    ProcessSpec:
+        The description of a process as given in the simulation file.
+*/
+
+class ProcessSpec {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        process_id:
+            The process's ID, as assigned in the simulation file.
+    */
+    int process_id = -1;
+
+    /*
+        priority:
+            The process's priority.
+    */
+    ProcessPriority priority = SYSTEM;
+
+    /*
+        first_thread, num_threads:
+            The process's threads are Workload::threads[first_thread, first_thread + num_threads).
+    */
+    size_t first_thread = 0;
+    size_t num_threads = 0;
+};
+
+/*
+    Workload:
+        Everything read from a simulation file, stored in flat arrays. A workload is
+        immutable once loaded, so any number of simulations (one after another or in
+        parallel) can share it and run different policies over it without reading
+        the file again.
+*/
+
+class Workload {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        thread_switch_overhead, process_switch_overhead:
+            The dispatch overheads given in the simulation file.
+    */
+    SimTime thread_switch_overhead = 0;
+    SimTime process_switch_overhead = 0;
+
+    /*
+        processes:
+            The processes, in the order they appear in the simulation file.
+    */
+    std::vector<ProcessSpec> processes;
+
+    /*
+        threads:
+            Every thread, grouped by process, in the order they appear in the file.
+    */
+    std::vector<ThreadSpec> threads;
+
+    /*
+        bursts:
+            Every burst of every thread, in order.
+    */
+    std::vector<Burst> bursts;
+
+    /*
+        arrival_order:
+            Indices into threads, sorted by arrival time (ties keep file order). The
+            simulation feeds arrivals from this list instead of queueing an event per
+            thread up front.
+    */
+    std::vector<uint32_t> arrival_order;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        read_file(filename):
+            Reads a simulation file and returns the workload it describes. Throws
+            std::logic_error if the file cannot be opened or is not valid.
+    */
+    static std::shared_ptr<const Workload> read_file(const std::string& filename);
+
+    /*
+        read(input):
+            Reads a workload in the simulation file format from a stream. Throws
+            std::logic_error if it is malformed or fails check_times().
+    */
+    static std::shared_ptr<const Workload> read(std::istream& input);
+
+    /*
+        write(output):
+            Writes the workload in the simulation file format, so that reading it back
+            gives the same workload.
+    */
+    void write(std::ostream& output) const;
+
+    /*
+        sort_arrivals():
+            Fills arrival_order. Called once all threads have been added (by read, or
+            by code building a workload directly).
+    */
+    void sort_arrivals();
+
+    /*
+        check_times():
+            Makes sure the workload can be simulated without any time overflowing
+            SimTime, whatever the policy: no time is negative, and the last arrival
+            plus every burst plus the worst-case dispatch overhead of every tick of
+            CPU time (as if a time slice of 1 preempted each one) fits. Checked once
+            here so the event loop never has to. Throws std::logic_error if not.
+    */
+    void check_times() const;
+
+private:
+
+    /*
+        read_process(input):
+            Reads in a process (and its threads) from the simulation file.
+    */
+    void read_process(std::istream& input);
+
+    /*
+        read_thread(input, thread_id, process_id, priority):
+            Reads in a thread (and its bursts) from the simulation file.
+    */
+    void read_thread(std::istream& input, int thread_id, int process_id, ProcessPriority priority);
+};
+
+#endif
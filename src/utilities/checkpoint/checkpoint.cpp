@@ -0,0 +1,108 @@
+#include "utilities/checkpoint/checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+static const char CHECKPOINT_MAGIC[8] = {'C', 'P', 'U', 'S', 'I', 'M', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 2;
+
+// Values smaller than this are gathered in the buffer before being written.
+static const size_t BUFFER_SIZE = 1 << 20;
+
+//==============================================================================
+// CheckpointWriter
+//==============================================================================
+
+CheckpointWriter::CheckpointWriter(const std::string& filename, const std::vector<uint32_t>& layout):
+    filename(filename), temporary(filename + ".tmp") {
+
+    this->file.open(this->temporary.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!this->file) {
+        std::cerr << "Unable to open checkpoint file: " << this->temporary << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+    this->buffer.reserve(BUFFER_SIZE);
+
+    this->write_bytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    this->write(CHECKPOINT_VERSION);
+    this->write_vector(layout);
+}
+
+void CheckpointWriter::write_string(const std::string& text) {
+    this->write<uint64_t>(text.size());
+    this->write_bytes(text.data(), text.size());
+}
+
+void CheckpointWriter::write_bytes(const void* data, size_t size) {
+    if (this->buffer.size() + size > BUFFER_SIZE) {
+        this->flush();
+    }
+    if (size >= BUFFER_SIZE) {
+        this->file.write(static_cast<const char*>(data), size);
+        return;
+    }
+    const char* bytes = static_cast<const char*>(data);
+    this->buffer.insert(this->buffer.end(), bytes, bytes + size);
+}
+
+void CheckpointWriter::flush() {
+    this->file.write(this->buffer.data(), this->buffer.size());
+    this->buffer.clear();
+}
+
+void CheckpointWriter::commit() {
+    this->flush();
+    this->file.close();
+
+    if (this->file.fail() || std::rename(this->temporary.c_str(), this->filename.c_str()) != 0) {
+        std::cerr << "Unable to write checkpoint file: " << this->filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+}
+
+//==============================================================================
+// CheckpointReader
+//==============================================================================
+
+CheckpointReader::CheckpointReader(const std::string& filename, const std::vector<uint32_t>& layout):
+    filename(filename) {
+
+    this->file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!this->file) {
+        std::cerr << "Unable to open checkpoint file: " << filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    this->file.read(magic, sizeof(magic));
+    if (!this->file || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        this->fail("not a checkpoint");
+    }
+
+    std::vector<uint32_t> written;
+    uint32_t version = this->read<uint32_t>();
+    this->read_vector(written);
+    if (version != CHECKPOINT_VERSION || written != layout) {
+        this->fail("written by an incompatible build");
+    }
+}
+
+std::string CheckpointReader::read_string() {
+    std::string text(this->read<uint64_t>(), '\0');
+    this->read_bytes(&text[0], text.size());
+    return text;
+}
+
+void CheckpointReader::read_bytes(void* data, size_t size) {
+    this->file.read(static_cast<char*>(data), size);
+    if (!this->file) {
+        this->fail("truncated");
+    }
+}
+
+void CheckpointReader::fail(const std::string& message) const {
+    std::cerr << "Unable to restore checkpoint " << this->filename << ": " << message << "." << std::endl;
+    throw(std::logic_error("Bad checkpoint."));
+}
@@ -0,0 +1,162 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+    Checkpoint files:
+        A checkpoint is a header (magic, format version and the sizes of the records
+        it holds, so a checkpoint from an incompatible build is refused rather than
+        misread) followed by values copied straight from memory. Arrays are written
+        with one call each, so saving is bound by the disk rather than by encoding.
+        Checkpoints are meant to be read back by the same build on the same kind of
+        machine, not to be kept or exchanged.
+*/
+
+/*
+    CheckpointWriter:
+        Writes a checkpoint. Everything goes to a temporary file next to the target,
+        which only replaces the target in commit(), so a run killed while saving still
+        leaves the previous checkpoint intact.
+*/
+
+class CheckpointWriter {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        CheckpointWriter(filename, layout):
+            Starts a checkpoint to be saved as filename. layout describes the records
+            that will be written (see CheckpointReader). Throws std::logic_error if the
+            temporary file cannot be created.
+    */
+    CheckpointWriter(const std::string& filename, const std::vector<uint32_t>& layout);
+
+    /*
+        write(value), write_array(values, count), write_vector(values), write_string(text):
+            Append values of trivially copyable types. Vectors and strings are
+            preceded by their length.
+    */
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoints hold raw values");
+        this->write_bytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void write_array(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoints hold raw values");
+        this->write_bytes(values, sizeof(T) * count);
+    }
+
+    template <typename T, typename Allocator>
+    void write_vector(const std::vector<T, Allocator>& values) {
+        this->write<uint64_t>(values.size());
+        this->write_array(values.data(), values.size());
+    }
+
+    void write_string(const std::string& text);
+
+    /*
+        commit():
+            Flushes the checkpoint and moves it over the target file. Throws
+            std::logic_error if anything could not be written.
+    */
+    void commit();
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::string filename;
+    std::string temporary;
+    std::ofstream file;
+
+    /*
+        buffer:
+            Small values are gathered here; large arrays go to the file directly.
+    */
+    std::vector<char> buffer;
+
+    void write_bytes(const void* data, size_t size);
+    void flush();
+};
+
+/*
+    CheckpointReader:
+        Reads a checkpoint written by CheckpointWriter, in the same order.
+*/
+
+class CheckpointReader {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        CheckpointReader(filename, layout):
+            Opens a checkpoint. Throws std::logic_error if it cannot be opened, is not
+            a checkpoint, or was written with a different layout (the sizes of the
+            records written, in some fixed order, so changing any record type makes
+            older checkpoints unreadable instead of misread).
+    */
+    CheckpointReader(const std::string& filename, const std::vector<uint32_t>& layout);
+
+    /*
+        read(), read_array(values, count), read_vector(values), read_string():
+            The counterparts of CheckpointWriter's functions. Throw std::logic_error
+            if the checkpoint ends early.
+    */
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoints hold raw values");
+        T value;
+        this->read_bytes(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void read_array(T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoints hold raw values");
+        this->read_bytes(values, sizeof(T) * count);
+    }
+
+    template <typename T, typename Allocator>
+    void read_vector(std::vector<T, Allocator>& values) {
+        values.resize(this->read<uint64_t>());
+        this->read_array(values.data(), values.size());
+    }
+
+    std::string read_string();
+
+    /*
+        fail(message):
+            Reports that the checkpoint does not fit the run restoring it, and throws
+            std::logic_error.
+    */
+    [[noreturn]] void fail(const std::string& message) const;
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::string filename;
+    std::ifstream file;
+
+    void read_bytes(void* data, size_t size);
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include "utilities/chrome_trace/chrome_trace.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "utilities/fmt/format.h"
+
+// How much trace text to collect before writing it out.
+static const size_t BUFFER_SIZE = 1 << 16;
+
+// The track group of the CPU. Process groups start at 1.
+static const int64_t CPU_PID = 0;
+
+// Each thread gets two tracks in its process's group: its states, then its I/O.
+static int64_t state_tid(const Thread* thread) { return (int64_t) thread->thread_id * 2; }
+static int64_t io_tid(const Thread* thread) { return (int64_t) thread->thread_id * 2 + 1; }
+
+ChromeTraceWriter::ChromeTraceWriter(const std::string& filename, std::shared_ptr<const Workload> workload) :
+    workload(workload) {
+
+    this->file.open(filename.c_str(), std::ios::out | std::ios::trunc);
+
+    if (!this->file) {
+        std::cerr << "Unable to open trace file: " << filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+
+    this->state_start.resize(workload->threads.size(), 0);
+    this->process_named.resize(workload->processes.size(), false);
+
+    this->buffer.reserve(BUFFER_SIZE + 256);
+    this->buffer = "{\"traceEvents\": [\n";
+    fmt::format_to(std::back_inserter(this->buffer),
+        "{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {0}, \"args\": {{\"name\": \"CPU\"}}}},\n"
+        "{{\"name\": \"process_sort_index\", \"ph\": \"M\", \"pid\": {0}, \"args\": {{\"sort_index\": -1}}}},\n"
+        "{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": {0}, \"tid\": 0, \"args\": {{\"name\": \"CPU\"}}}}",
+        CPU_PID);
+}
+
+ChromeTraceWriter::~ChromeTraceWriter() {
+    this->close();
+}
+
+void ChromeTraceWriter::record_transition(int64_t time, const Thread* thread, ThreadState before_state) {
+    int64_t start = this->state_start[thread->handle];
+    int64_t pid = (int64_t) this->workload->threads[thread->handle].process_index + 1;
+
+    switch (before_state) {
+        case NEW:
+            this->name_tracks(thread);
+            break;
+
+        case READY:
+            this->add_slice("Ready", pid, state_tid(thread), start, time);
+            break;
+
+        case RUNNING:
+            this->add_slice("Running", pid, state_tid(thread), start, time);
+            this->add_slice(fmt::format("P{} T{}", thread->process_id, thread->thread_id), CPU_PID, 0, start, time);
+            break;
+
+        case BLOCKED:
+            this->add_slice("I/O", pid, io_tid(thread), start, time);
+            break;
+
+        case EXIT:
+        case NUM_THREAD_STATES:
+            break;
+    }
+
+    this->state_start[thread->handle] = time;
+
+    if (this->buffer.size() >= BUFFER_SIZE) {
+        this->flush();
+    }
+}
+
+void ChromeTraceWriter::record_dispatch(int64_t time, int64_t overhead, const Thread* thread, bool process_switch) {
+    std::string name = fmt::format("{} to P{} T{}", process_switch ? "Process dispatch" : "Thread dispatch",
+        thread->process_id, thread->thread_id);
+    this->add_slice(name, CPU_PID, 0, time, time + overhead);
+}
+
+void ChromeTraceWriter::add_slice(const std::string& name, int64_t pid, int64_t tid, int64_t start, int64_t end) {
+    if (end <= start) {
+        return;
+    }
+
+    fmt::format_to(std::back_inserter(this->buffer),
+        ",\n{{\"name\": \"{}\", \"ph\": \"X\", \"ts\": {}, \"dur\": {}, \"pid\": {}, \"tid\": {}}}",
+        name, start, end - start, pid, tid);
+}
+
+void ChromeTraceWriter::name_tracks(const Thread* thread) {
+    size_t process_index = this->workload->threads[thread->handle].process_index;
+    int64_t pid = (int64_t) process_index + 1;
+    auto it = std::back_inserter(this->buffer);
+
+    if (!this->process_named[process_index]) {
+        fmt::format_to(it,
+            ",\n{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {}, \"args\": {{\"name\": \"Process {} [{}]\"}}}}",
+            pid, thread->process_id, PROCESS_PRIORITY_NAMES[thread->priority]);
+        fmt::format_to(it,
+            ",\n{{\"name\": \"process_sort_index\", \"ph\": \"M\", \"pid\": {0}, \"args\": {{\"sort_index\": {0}}}}}",
+            pid);
+        this->process_named[process_index] = true;
+    }
+
+    fmt::format_to(it,
+        ",\n{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": {}, \"tid\": {}, \"args\": {{\"name\": \"Thread {}\"}}}}",
+        pid, state_tid(thread), thread->thread_id);
+    fmt::format_to(it,
+        ",\n{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": {}, \"tid\": {}, \"args\": {{\"name\": \"Thread {} I/O\"}}}}",
+        pid, io_tid(thread), thread->thread_id);
+}
+
+void ChromeTraceWriter::flush() {
+    this->file.write(this->buffer.data(), this->buffer.size());
+    this->buffer.clear();
+}
+
+void ChromeTraceWriter::close() {
+    if (this->file.is_open()) {
+        this->buffer += "\n]}\n";
+        this->flush();
+        this->file.close();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef CHROME_TRACE_HPP
+#define CHROME_TRACE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types/enums.hpp"
+#include "types/thread/thread.hpp"
+#include "types/workload/workload.hpp"
+
+/*
+    ChromeTraceWriter:
+        Writes the simulated schedule as a Chrome trace-event JSON file, which can be
+        opened in Perfetto (ui.perfetto.dev) or chrome://tracing. One tick of
+        simulated time is shown as one microsecond.
+
+        The timeline has a "CPU" track with a slice for every burst run and every
+        dispatch, and a group per simulated process with two tracks per thread: one
+        with the thread's ready and running periods and one with its I/O bursts.
+
+        Slices are written as soon as they end, through a buffer that is flushed to the
+        file in large chunks, so the trace is streamed while simulating rather than
+        kept in memory. Only the time of each thread's last state change is kept.
+*/
+
+class ChromeTraceWriter {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        ChromeTraceWriter(filename, workload):
+            Opens filename and starts the trace of a run of workload. Throws
+            std::logic_error if the file cannot be opened.
+    */
+    ChromeTraceWriter(const std::string& filename, std::shared_ptr<const Workload> workload);
+
+    ~ChromeTraceWriter();
+
+    /*
+        record_transition(time, thread, before_state):
+            Ends the period the thread spent in before_state, adding its slice.
+    */
+    void record_transition(int64_t time, const Thread* thread, ThreadState before_state);
+
+    /*
+        record_dispatch(time, overhead, thread, process_switch):
+            Adds the slice of the dispatcher switching the CPU to thread.
+    */
+    void record_dispatch(int64_t time, int64_t overhead, const Thread* thread, bool process_switch);
+
+    /*
+        close():
+            Finishes the JSON document and closes the file. Called by the destructor
+            if it was not called before.
+    */
+    void close();
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::ofstream file;
+
+    std::shared_ptr<const Workload> workload;
+
+    /*
+        buffer:
+            The trace text not written to the file yet.
+    */
+    std::string buffer;
+
+    /*
+        state_start:
+            When each thread (by handle) entered its current state.
+    */
+    std::vector<int64_t> state_start;
+
+    /*
+        process_named:
+            Whether the track group of each process (by index) has been named yet.
+    */
+    std::vector<bool> process_named;
+
+    /*
+        add_slice(name, pid, tid, start, end):
+            Adds a complete slice to the given track.
+    */
+    void add_slice(const std::string& name, int64_t pid, int64_t tid, int64_t start, int64_t end);
+
+    /*
+        name_tracks(thread):
+            Names the tracks of a newly arrived thread (and of its process, the first
+            time one of its threads arrives).
+    */
+    void name_tracks(const Thread* thread);
+
+    /*
+        flush():
+            Writes the buffer to the file and empties it.
+    */
+    void flush();
+};
+
+#endif
@@ -1,8 +1,11 @@
 #include "utilities/flags/flags.hpp"
 
+#include "utilities/generator/generator.hpp"
+
 void print_usage() {
     std::cout <<
         "Usage: cpu-sim [options] filename\n"
+        "       cpu-sim [options] -g <generator options>\n"
         "\n"
         "Options\n"
         "   -h, --help:\n"
@@ -11,6 +14,10 @@ void print_usage() {
         "   -m, --metrics:\n"
         "       If set, outputs general metrics for the simulation.\n"
         "\n"
+        "   -l, --latency:\n"
+        "       If set, outputs p50/p90/p99/p99.9/max response, turnaround, ready queue wait\n"
+        "       and burst wait times per priority.\n"
+        "\n"
         "   -s, --time_slice <value>:\n"
         "       Set the default time slice for a pre-emptive algorithms. Must be greater than zero.\n"
         "\n"
@@ -26,10 +33,148 @@ void print_usage() {
         "           RR: round-robin scheduling\n"
         "           PRIORITY: priority scheduling\n"
         "           MLFQ: multilevel feedback queue\n"
-        "           CUSTOM: A custom algorithm\n";
+        "           CUSTOM: A custom algorithm\n"
+        "\n"
+        "   -c, --compare:\n"
+        "       Run every implemented algorithm over the same input (in parallel) and print\n"
+        "       a side-by-side comparison of their metrics. The time slice, if given, is\n"
+        "       used by the preemptive algorithms.\n"
+        "\n"
+        "   -b, --baseline <algorithm>:\n"
+        "       The algorithm the others are compared against with --compare (default FCFS).\n"
+        "\n"
+        "   --branch_at <time>:\n"
+        "       With --compare, simulate the run only once up to <time>, with the algorithm\n"
+        "       given with -a, then continue it from there with every algorithm (in\n"
+        "       parallel). The runs then differ only in what happens after <time>, and\n"
+        "       the shared part is not simulated again for each of them.\n"
+        "       Only the scheduler and its time slice differ between the runs: the\n"
+        "       workload and every other option are the same. At <time>, the thread on\n"
+        "       the CPU keeps running under the new time slice, counted from its dispatch\n"
+        "       (it is preempted at <time> if it has already run longer than that), and\n"
+        "       dispatches under way take the new time slice. The waiting threads are\n"
+        "       queued in the order they became ready.\n"
+        "\n"
+        "   -g, --generate <options>:\n"
+        "       Simulate a synthetic workload generated in memory instead of reading a file.\n"
+        "       The options are key=value pairs separated by spaces, e.g.\n"
+        "           \"threads=100000 seed=7 interarrival=exp:20 batch.cpu_burst=pareto:10:1.5\"\n"
+        "       Keys: threads, seed, interarrival, thread_switch, process_switch, and per\n"
+        "       priority (optionally prefixed with system., interactive., normal. or batch.)\n"
+        "       weight, threads_per_process, cpu_bursts, cpu_burst and io_burst. Values other\n"
+        "       than counts are distributions: const:V, uniform:LOW:HIGH, exp:MEAN,\n"
+        "       lognormal:MU:SIGMA, pareto:SCALE:SHAPE or empirical:V@P,V@P,... (a CDF).\n"
+        "       cpu-sim-gen writes the same workloads to simulation files.\n"
+        "\n"
+        "   --max_time <time>, --max_events <count>, --max_completed <count>:\n"
+        "       Stop early: before the first event after <time>, after <count> events, or\n"
+        "       once <count> threads have exited. The metrics then cover the run up to that\n"
+        "       point: the time totals count only the work done by then, and the per-thread\n"
+        "       and per-priority metrics only the threads that have exited.\n"
+        "\n"
+        "   --converge <precision>:\n"
+        "       Stop early once the mean turnaround time is known to within <precision>\n"
+        "       (e.g. 0.05 for +/-5%) with 95% confidence, from batches of 100 threads.\n"
+        "\n"
+        "   --checkpoint <file>, --checkpoint_interval <seconds>:\n"
+        "       Save the state of the run to file every <seconds> (default 300) and when it\n"
+        "       stops early (a limit above, SIGTERM or SIGINT). The file is replaced\n"
+        "       atomically, so it always holds a complete checkpoint.\n"
+        "\n"
+        "   --restore <file>:\n"
+        "       Resume the run saved in a checkpoint, with the same workload and options\n"
+        "       (limits may be changed, e.g. to continue a run stopped by --max_events).\n"
+        "       The results are those of the uninterrupted run. Not available with -c,\n"
+        "       -e, -T or -C.\n"
+        "\n"
+        "   --arrival_rate <rate>:\n"
+        "       Simulate an open system: threads shaped as given with -g (or the generator's\n"
+        "       defaults) arrive as a Poisson process of <rate> threads per tick, instead of\n"
+        "       from a file. Threads are retired as with -r. At the end, steady-state metrics\n"
+        "       are printed with 95% confidence intervals (batch means), or a warning if\n"
+        "       the run has no steady state (the load is too high for the CPU).\n"
+        "\n"
+        "   --duration <ticks>:\n"
+        "       How long an open-system run lasts (default 1000000).\n"
+        "\n"
+        "   --warmup <ticks>:\n"
+        "       Leave threads exiting before this time out of the steady-state metrics\n"
+        "       (default: detect the warm-up with MSER).\n"
+        "\n"
+        "   --batches <count>:\n"
+        "       The number of batches for the confidence intervals (default 20).\n"
+        "\n"
+        "   -r, --retire:\n"
+        "       Free each thread's memory as soon as it exits, so memory stays proportional to\n"
+        "       the number of live threads. Per-thread metrics are then printed as each thread\n"
+        "       exits instead of grouped by process at the end.\n"
+        "\n"
+        "   -e, --export <file>:\n"
+        "       Write the metrics of every thread to file as the threads exit: as CSV if the\n"
+        "       name ends in .csv, otherwise in a columnar binary format (see thread_export.hpp).\n"
+        "\n"
+        "   -f, --format <format>:\n"
+        "       The format of the end-of-run report. Valid values are:\n"
+        "           text: human-readable output selected by -t, -m and -l (default)\n"
+        "           json: a single JSON document with all the metrics, the run\n"
+        "                 configuration and the simulator's own timing\n"
+        "\n"
+        "   -T, --trace <file>:\n"
+        "       Record every state transition and scheduling choice to file in a compact\n"
+        "       binary format. cpu-sim-trace <file> prints it as -v would have.\n"
+        "\n"
+        "   -C, --chrome_trace <file>:\n"
+        "       Write the schedule to file as a Chrome trace (JSON), to view in Perfetto or\n"
+        "       chrome://tracing. One tick is shown as one microsecond.\n"
+        "\n"
+        "   -A, --async_log:\n"
+        "       Format and print the verbose output (and with -r, the per-thread metrics)\n"
+        "       on a background thread, so the simulation itself is not slowed down by it.\n"
+        "\n"
+        "   --filter_process <ids>, --filter_thread <ids>:\n"
+        "       Only print the verbose output about the given (comma-separated) process or\n"
+        "       thread IDs.\n"
+        "\n"
+        "   --filter_priority <priorities>:\n"
+        "       Only print the verbose output about threads of the given priorities, e.g.\n"
+        "       SYSTEM,BATCH.\n"
+        "\n"
+        "   --filter_event <events>:\n"
+        "       Only print the verbose output for the given event types, e.g.\n"
+        "       THREAD_ARRIVED,DISPATCHER_INVOKED.\n"
+        "\n"
+        "   --filter_time <start:end>:\n"
+        "       Only print the verbose output for events in the given time range (inclusive);\n"
+        "       either end may be left out.\n"
+        "\n"
+        "   -p, --profile:\n"
+        "       Print the simulator's own performance counters (events and time per event\n"
+        "       type, event queue high-water mark, scheduler calls, allocations). Only\n"
+        "       available in builds made with `make PROFILE=1`.\n";
 }
 
 
+// Values returned by getopt_long for the options without a short form.
+enum LongOnlyFlags {
+    FILTER_PROCESS_FLAG = 256,
+    FILTER_THREAD_FLAG,
+    FILTER_PRIORITY_FLAG,
+    FILTER_EVENT_FLAG,
+    FILTER_TIME_FLAG,
+    ARRIVAL_RATE_FLAG,
+    DURATION_FLAG,
+    WARMUP_FLAG,
+    BATCHES_FLAG,
+    MAX_TIME_FLAG,
+    MAX_EVENTS_FLAG,
+    MAX_COMPLETED_FLAG,
+    CONVERGE_FLAG,
+    CHECKPOINT_FLAG,
+    CHECKPOINT_INTERVAL_FLAG,
+    RESTORE_FLAG,
+    BRANCH_AT_FLAG
+};
+
 int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
     flags.per_thread = false;
     flags.verbose = false;
@@ -39,19 +184,47 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
     static struct option flag_options[] = {
         {"per_thread",  no_argument,        0, 't'},
         {"metrics",     no_argument,        0, 'm'},
+        {"latency",     no_argument,        0, 'l'},
         {"verbose",     no_argument,        0, 'v'},
         {"algorithm",   required_argument,  0, 'a'},
         {"time_slice",  required_argument,  0, 's'},
         {"help",        no_argument,        0, 'h'},
+        {"compare",     no_argument,        0, 'c'},
+        {"baseline",    required_argument,  0, 'b'},
+        {"retire",      no_argument,        0, 'r'},
+        {"generate",    required_argument,  0, 'g'},
+        {"export",      required_argument,  0, 'e'},
+        {"format",      required_argument,  0, 'f'},
+        {"trace",       required_argument,  0, 'T'},
+        {"chrome_trace", required_argument, 0, 'C'},
+        {"async_log",   no_argument,        0, 'A'},
+        {"profile",     no_argument,        0, 'p'},
+        {"filter_process",  required_argument,  0, FILTER_PROCESS_FLAG},
+        {"filter_thread",   required_argument,  0, FILTER_THREAD_FLAG},
+        {"filter_priority", required_argument,  0, FILTER_PRIORITY_FLAG},
+        {"filter_event",    required_argument,  0, FILTER_EVENT_FLAG},
+        {"filter_time",     required_argument,  0, FILTER_TIME_FLAG},
+        {"arrival_rate",    required_argument,  0, ARRIVAL_RATE_FLAG},
+        {"duration",        required_argument,  0, DURATION_FLAG},
+        {"warmup",          required_argument,  0, WARMUP_FLAG},
+        {"batches",         required_argument,  0, BATCHES_FLAG},
+        {"max_time",        required_argument,  0, MAX_TIME_FLAG},
+        {"max_events",      required_argument,  0, MAX_EVENTS_FLAG},
+        {"max_completed",   required_argument,  0, MAX_COMPLETED_FLAG},
+        {"converge",        required_argument,  0, CONVERGE_FLAG},
+        {"checkpoint",      required_argument,  0, CHECKPOINT_FLAG},
+        {"checkpoint_interval", required_argument, 0, CHECKPOINT_INTERVAL_FLAG},
+        {"restore",         required_argument,  0, RESTORE_FLAG},
+        {"branch_at",       required_argument,  0, BRANCH_AT_FLAG},
         {0, 0, 0, 0}
     };
 
     int option_index;
-    char flag_char;
+    int flag_char;
 
     // Parse flags entered by the user.
     while (true) {
-        flag_char = getopt_long(argc, argv, "-s:tvhma:", flag_options, &option_index);
+        flag_char = getopt_long(argc, argv, "-s:tvhmla:cb:re:f:T:C:Apg:", flag_options, &option_index);
 
         // Detect the end of the options.
         if (flag_char == -1) {
@@ -71,6 +244,10 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
                 flags.metrics = true;
                 break;
 
+            case 'l':
+                flags.latency = true;
+                break;
+
             case 'a':
                 flags.scheduler = get_scheduler();
                 break;
@@ -79,6 +256,167 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
                 return 1;
                 break;
 
+            case 'c':
+                flags.compare = true;
+                break;
+
+            case 'r':
+                flags.retire = true;
+                break;
+
+            case 'g': {
+                GeneratorOptions options;
+                if (!options.parse(optarg)) { return 1; }
+                flags.generate = optarg;
+                break;
+            }
+
+            case 'e':
+                flags.export_file = optarg;
+                break;
+
+            case 'T':
+                flags.trace_file = optarg;
+                break;
+
+            case 'C':
+                flags.chrome_trace_file = optarg;
+                break;
+
+            case 'A':
+                flags.async_log = true;
+                break;
+
+            case 'p':
+                flags.profile = true;
+                break;
+
+            case FILTER_PROCESS_FLAG:
+                if (!flags.verbose_filter.parse_processes(optarg)) { return 1; }
+                break;
+
+            case FILTER_THREAD_FLAG:
+                if (!flags.verbose_filter.parse_threads(optarg)) { return 1; }
+                break;
+
+            case FILTER_PRIORITY_FLAG:
+                if (!flags.verbose_filter.parse_priorities(optarg)) { return 1; }
+                break;
+
+            case FILTER_EVENT_FLAG:
+                if (!flags.verbose_filter.parse_events(optarg)) { return 1; }
+                break;
+
+            case FILTER_TIME_FLAG:
+                if (!flags.verbose_filter.parse_time_range(optarg)) { return 1; }
+                break;
+
+            case ARRIVAL_RATE_FLAG:
+                try {
+                    flags.arrival_rate = std::stod(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (!(flags.arrival_rate > 0)) { return 1; }
+                break;
+
+            case DURATION_FLAG:
+                try {
+                    flags.duration = std::stoll(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (flags.duration <= 0) { return 1; }
+                break;
+
+            case WARMUP_FLAG:
+                try {
+                    flags.warmup = std::stoll(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (flags.warmup < 0) { return 1; }
+                break;
+
+            case BATCHES_FLAG:
+                try {
+                    flags.batches = std::stoi(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (flags.batches < 2) { return 1; }
+                break;
+
+            case MAX_TIME_FLAG:
+                try {
+                    flags.max_time = std::stoll(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (flags.max_time <= 0) { return 1; }
+                break;
+
+            case MAX_EVENTS_FLAG:
+                try {
+                    flags.max_events = std::stoull(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                break;
+
+            case MAX_COMPLETED_FLAG:
+                try {
+                    flags.max_completed = std::stoull(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                break;
+
+            case CONVERGE_FLAG:
+                try {
+                    flags.converge = std::stod(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (!(flags.converge > 0)) { return 1; }
+                break;
+
+            case CHECKPOINT_FLAG:
+                flags.checkpoint_file = optarg;
+                break;
+
+            case CHECKPOINT_INTERVAL_FLAG:
+                try {
+                    flags.checkpoint_interval = std::stod(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (!(flags.checkpoint_interval > 0)) { return 1; }
+                break;
+
+            case RESTORE_FLAG:
+                flags.restore_file = optarg;
+                break;
+
+            case BRANCH_AT_FLAG:
+                try {
+                    flags.branch_at = std::stoll(optarg);
+                } catch (...) {
+                    return 1;
+                }
+                if (flags.branch_at <= 0) { return 1; }
+                break;
+
+            case 'f':
+                flags.format = optarg;
+                if (flags.format != "text" && flags.format != "json") { return 1; }
+                break;
+
+            case 'b':
+                flags.baseline = get_scheduler();
+                if (flags.baseline == "ERROR") { return 1; }
+                break;
+
             case 's':
                 try {
                     flags.time_slice  = std::stoi(optarg);
@@ -86,6 +424,7 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
                 } catch (...) {
                     return 1;
                 }
+                break;
 
             case 1:
                 flags.filename = optarg;
@@ -96,7 +435,27 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
         }
     }
 
-    if (flags.filename == "") {
+    // An open system is generated as it runs: there is no file, nor a thread table
+    // for the traces, and every run is open, so there is nothing to compare.
+    bool open_system = flags.arrival_rate > 0;
+    if (open_system && (flags.filename != "" || flags.compare || flags.async_log
+            || flags.trace_file != "" || flags.chrome_trace_file != "")) {
+        return 1;
+    }
+
+    if (flags.filename == "" && flags.generate == "" && !open_system) {
+        return 1;
+    }
+
+    // A resumed run only produces the output from where it resumed, so the files
+    // written as the run goes would miss their beginning.
+    bool checkpointing = flags.checkpoint_file != "" || flags.restore_file != "";
+    if (checkpointing && (flags.compare || flags.export_file != "" || flags.trace_file != ""
+            || flags.chrome_trace_file != "")) {
+        return 1;
+    }
+
+    if (flags.branch_at != 0 && !flags.compare) {
         return 1;
     }
 
@@ -108,7 +467,8 @@ int parse_flags(int argc, char* const argv[], FlagOptions& flags) {
         return 1;
     }
 
-    if ((flags.scheduler == "FCFS" || flags.scheduler == "PRIORITY") && (flags.time_slice != -1)) {
+    // In compare mode the time slice only goes to the preemptive algorithms.
+    if (!flags.compare && (flags.scheduler == "FCFS" || flags.scheduler == "PRIORITY") && (flags.time_slice != -1)) {
         return 1;
     }
 
@@ -8,6 +8,9 @@
 #include <iostream>
 #include <string>
 
+#include "types/sim_time/sim_time.hpp"
+#include "utilities/verbose_filter/verbose_filter.hpp"
+
 /*
     FlagOptions:
         A class that contains useful information about the
@@ -29,6 +32,15 @@ public:
     */
     std::string filename = "";
 
+    /*
+        generate:
+            If not empty, the options of a synthetic workload to simulate instead of
+            reading a file (see GeneratorOptions::parse).
+
+            Set with the -g, --generate flag.
+    */
+    std::string generate = "";
+
     /*
         verbose:
             Whether or not the simulation should print verbose, per-state transitions.
@@ -55,6 +67,176 @@ public:
     */
     bool metrics = false;
 
+    /*
+        latency:
+            Whether or not the simulation should print latency percentiles per
+            priority at the end of the simulation.
+
+            Set to true with the -l, --latency flag.
+    */
+    bool latency = false;
+
+    /*
+        retire:
+            Whether threads should be freed as soon as they exit instead of being
+            kept until the end of the simulation. Their per-thread metrics are then
+            printed as they exit.
+
+            Set to true with the -r, --retire flag.
+    */
+    bool retire = false;
+
+    /*
+        export_file:
+            Where to write the metrics of every thread as they exit, or empty for
+            no export.
+
+            Set with the -e, --export flag.
+    */
+    std::string export_file = "";
+
+    /*
+        trace_file:
+            Where to record a binary trace of the run, or empty for no trace.
+
+            Set with the -T, --trace flag.
+    */
+    std::string trace_file = "";
+
+    /*
+        chrome_trace_file:
+            Where to write the schedule as a Chrome trace, or empty for none.
+
+            Set with the -C, --chrome_trace flag.
+    */
+    std::string chrome_trace_file = "";
+
+    /*
+        async_log:
+            Whether the output produced while simulating should be formatted and
+            printed on a background thread.
+
+            Set to true with the -A, --async_log flag.
+    */
+    bool async_log = false;
+
+    /*
+        verbose_filter:
+            Which blocks of the verbose output to print.
+
+            Set with the --filter_process, --filter_thread, --filter_priority,
+            --filter_event and --filter_time flags.
+    */
+    VerboseFilter verbose_filter;
+
+    /*
+        profile:
+            Whether to print the simulator's own performance counters at the end.
+
+            Set to true with the -p, --profile flag.
+    */
+    bool profile = false;
+
+    /*
+        max_time, max_events, max_completed:
+            Stop the run early once the next event is after max_time, once max_events
+            events have been processed, or once max_completed threads have exited.
+            0 for no limit.
+
+            Set with the --max_time, --max_events and --max_completed flags.
+    */
+    SimTime max_time = 0;
+    uint64_t max_events = 0;
+    uint64_t max_completed = 0;
+
+    /*
+        converge:
+            Stop the run early once the mean turnaround time is known within this
+            relative precision (95% confidence), e.g. 0.05 for +/-5%. 0 to never.
+
+            Set with the --converge flag.
+    */
+    double converge = 0.0;
+
+    /*
+        checkpoint_file, checkpoint_interval:
+            Where to save the state of the run every checkpoint_interval seconds (of
+            wall-clock time), and when it stops early (a limit above, or SIGTERM or
+            SIGINT), so it can be resumed with restore_file. Empty for none.
+
+            Set with the --checkpoint and --checkpoint_interval flags.
+    */
+    std::string checkpoint_file = "";
+    double checkpoint_interval = 300.0;
+
+    /*
+        restore_file:
+            A checkpoint to resume the run from, instead of starting it from the
+            beginning. The run must be given the same workload and options (the
+            limits above aside), and its results are then exactly those of a run
+            that was never interrupted. Empty to start from the beginning.
+
+            Set with the --restore flag.
+    */
+    std::string restore_file = "";
+
+    /*
+        branch_at:
+            In compare mode, the time up to which the runs are simulated only once,
+            with scheduler, before each algorithm continues from there. 0 to simulate
+            every run from the beginning. Only the scheduler and its time slice vary
+            between the runs; see Simulation::apply_branch_time_slice for how the
+            events in flight at the branch point follow the new time slice.
+
+            Set with the --branch_at flag.
+    */
+    SimTime branch_at = 0;
+
+    /*
+        arrival_rate:
+            If positive, the simulation is an open system: threads of the shape given
+            with -g are generated as a Poisson process of this many arrivals per tick,
+            and the run stops after duration ticks. 0 for a closed workload.
+
+            Set with the --arrival_rate flag.
+    */
+    double arrival_rate = 0.0;
+
+    /*
+        duration:
+            How long an open-system run lasts, in ticks.
+
+            Set with the --duration flag.
+    */
+    SimTime duration = 1000000;
+
+    /*
+        warmup:
+            The warm-up of an open-system run, in ticks: threads exiting before it are
+            left out of the steady-state metrics (in whole micro-batches, so a few of
+            the last ones may be kept). -1 to detect it (MSER).
+
+            Set with the --warmup flag.
+    */
+    SimTime warmup = -1;
+
+    /*
+        batches:
+            The number of batches the steady-state confidence intervals are computed
+            from.
+
+            Set with the --batches flag.
+    */
+    int batches = 20;
+
+    /*
+        format:
+            The format of the end-of-run report: "text" or "json".
+
+            Set with the -f, --format flag.
+    */
+    std::string format = "text";
+
     /*
         time_slice:
             The time slice for preemptive algorithms. Should be positive.
@@ -71,6 +253,24 @@ public:
             Set with the -a, --algorithm flag.
     */
     std::string scheduler = "";
+
+    /*
+        compare:
+            Whether to load the simulation file once and run every registered
+            algorithm over it, printing a side-by-side comparison of their metrics
+            instead of the normal output.
+
+            Set to true with the -c, --compare flag.
+    */
+    bool compare = false;
+
+    /*
+        baseline:
+            The algorithm the others are compared against in compare mode.
+
+            Set with the -b, --baseline flag. Defaults to FCFS.
+    */
+    std::string baseline = "FCFS";
 };
 
 /*
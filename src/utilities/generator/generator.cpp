@@ -0,0 +1,392 @@
+#include "utilities/generator/generator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+Distribution Distribution::constant(double value) {
+    Distribution distribution;
+    distribution.kind = CONSTANT;
+    distribution.a = value;
+    return distribution;
+}
+
+Distribution Distribution::uniform(double low, double high) {
+    Distribution distribution;
+    distribution.kind = UNIFORM;
+    distribution.a = low;
+    distribution.b = high;
+    return distribution;
+}
+
+Distribution Distribution::exponential(double mean) {
+    Distribution distribution;
+    distribution.kind = EXPONENTIAL;
+    distribution.a = mean;
+    return distribution;
+}
+
+// Splits text at every separator.
+static std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+// Parses a whole string as a finite number.
+static bool parse_number(const std::string& text, double& value) {
+    try {
+        size_t used = 0;
+        value = std::stod(text, &used);
+        return used == text.size() && std::isfinite(value);
+    } catch (...) {
+        return false;
+    }
+}
+
+bool Distribution::parse(const std::string& spec, Distribution& distribution) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::string name = spec.substr(0, colon);
+    std::string rest = spec.substr(colon + 1);
+    Distribution parsed;
+
+    if (name == "empirical") {
+        parsed.kind = EMPIRICAL;
+        for (const std::string& point : split(rest, ',')) {
+            size_t at = point.find('@');
+            double value, probability;
+            if (at == std::string::npos || !parse_number(point.substr(0, at), value)
+                    || !parse_number(point.substr(at + 1), probability) || value < 0
+                    || probability < 0 || probability > 1) {
+                return false;
+            }
+            // The CDF never decreases.
+            if (!parsed.points.empty() && (value < parsed.points.back().first || probability < parsed.points.back().second)) {
+                return false;
+            }
+            parsed.points.emplace_back(value, probability);
+        }
+        if (parsed.points.empty() || parsed.points.back().second != 1.0) {
+            return false;
+        }
+        distribution = parsed;
+        return true;
+    }
+
+    std::vector<double> parameters;
+    for (const std::string& part : split(rest, ':')) {
+        double value;
+        if (!parse_number(part, value)) {
+            return false;
+        }
+        parameters.push_back(value);
+    }
+
+    if (name == "const" && parameters.size() == 1 && parameters[0] >= 0) {
+        parsed = constant(parameters[0]);
+    } else if (name == "uniform" && parameters.size() == 2 && 0 <= parameters[0] && parameters[0] <= parameters[1]) {
+        parsed = uniform(parameters[0], parameters[1]);
+    } else if (name == "exp" && parameters.size() == 1 && parameters[0] > 0) {
+        parsed = exponential(parameters[0]);
+    } else if (name == "lognormal" && parameters.size() == 2 && parameters[1] >= 0) {
+        parsed.kind = LOGNORMAL;
+        parsed.a = parameters[0];
+        parsed.b = parameters[1];
+    } else if (name == "pareto" && parameters.size() == 2 && parameters[0] > 0 && parameters[1] > 0) {
+        parsed.kind = PARETO;
+        parsed.a = parameters[0];
+        parsed.b = parameters[1];
+    } else {
+        return false;
+    }
+
+    distribution = parsed;
+    return true;
+}
+
+double Distribution::sample(std::mt19937_64& random) const {
+    switch (this->kind) {
+        case CONSTANT:
+            return this->a;
+
+        case UNIFORM:
+            return (double) std::uniform_int_distribution<int64_t>((int64_t) this->a, (int64_t) this->b)(random);
+
+        case EXPONENTIAL:
+            return std::exponential_distribution<double>(1.0 / this->a)(random);
+
+        case LOGNORMAL:
+            return std::lognormal_distribution<double>(this->a, this->b)(random);
+
+        case PARETO: {
+            // Inverse transform; 1 - U is in (0, 1], so this never divides by zero.
+            double u = 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(random);
+            return this->a / std::pow(u, 1.0 / this->b);
+        }
+
+        case EMPIRICAL: {
+            double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+            auto point = std::lower_bound(this->points.begin(), this->points.end(), u,
+                [](const std::pair<double, double>& p, double probability) { return p.second < probability; });
+            if (point == this->points.begin()) {
+                return point->first;
+            }
+            // Interpolate between the two points around u.
+            auto previous = point - 1;
+            double span = point->second - previous->second;
+            double fraction = span == 0 ? 0.0 : (u - previous->second) / span;
+            return previous->first + fraction * (point->first - previous->first);
+        }
+    }
+    return 0.0;
+}
+
+double Distribution::mean() const {
+    switch (this->kind) {
+        case CONSTANT:
+        case EXPONENTIAL:
+            return this->a;
+
+        case UNIFORM:
+            return (this->a + this->b) / 2;
+
+        case LOGNORMAL:
+            return std::exp(this->a + this->b * this->b / 2);
+
+        case PARETO:
+            return this->b <= 1 ? std::numeric_limits<double>::infinity() : this->b * this->a / (this->b - 1);
+
+        case EMPIRICAL: {
+            // The mass below the first point sits on it; the rest is spread linearly.
+            double mean = this->points[0].first * this->points[0].second;
+            for (size_t i = 1; i < this->points.size(); ++i) {
+                double probability = this->points[i].second - this->points[i - 1].second;
+                mean += probability * (this->points[i].first + this->points[i - 1].first) / 2;
+            }
+            return mean;
+        }
+    }
+    return 0.0;
+}
+
+bool GeneratorOptions::set(const std::string& key, const std::string& value) {
+    try {
+        if (key == "threads") {
+            this->num_threads = std::stoull(value);
+            return true;
+        }
+        if (key == "seed") {
+            this->seed = std::stoull(value);
+            return true;
+        }
+        if (key == "thread_switch" || key == "process_switch") {
+            SimTime overhead = std::stoll(value);
+            if (overhead < 0) {
+                return false;
+            }
+            (key == "thread_switch" ? this->thread_switch_overhead : this->process_switch_overhead) = overhead;
+            return true;
+        }
+    } catch (...) {
+        return false;
+    }
+
+    if (key == "interarrival") {
+        return Distribution::parse(value, this->interarrival);
+    }
+
+    // Per-priority options, for every priority or for the one named before the dot.
+    int first = 0, last = NUM_PROCESS_PRIORITIES - 1;
+    std::string field = key;
+    size_t dot = key.find('.');
+    if (dot != std::string::npos) {
+        std::string name = key.substr(0, dot);
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+        auto found = std::find(std::begin(PROCESS_PRIORITY_NAMES), std::end(PROCESS_PRIORITY_NAMES), name);
+        if (found == std::end(PROCESS_PRIORITY_NAMES)) {
+            return false;
+        }
+        first = last = (int) (found - std::begin(PROCESS_PRIORITY_NAMES));
+        field = key.substr(dot + 1);
+    }
+
+    for (int priority = first; priority <= last; ++priority) {
+        PriorityProfile& profile = this->priorities[priority];
+        bool valid;
+        if (field == "weight") {
+            valid = parse_number(value, profile.weight) && profile.weight >= 0;
+        } else if (field == "threads_per_process") {
+            valid = Distribution::parse(value, profile.threads_per_process);
+        } else if (field == "cpu_bursts") {
+            valid = Distribution::parse(value, profile.cpu_bursts);
+        } else if (field == "cpu_burst") {
+            valid = Distribution::parse(value, profile.cpu_burst);
+        } else if (field == "io_burst") {
+            valid = Distribution::parse(value, profile.io_burst);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GeneratorOptions::parse(const std::string& list) {
+    std::stringstream stream(list);
+    std::string option;
+    while (stream >> option) {
+        size_t equals = option.find('=');
+        if (equals == std::string::npos || !this->set(option.substr(0, equals), option.substr(equals + 1))) {
+            std::cerr << "Invalid generator option: " << option << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double GeneratorOptions::mean_cpu_demand() const {
+    // Each priority's share of the threads is its share of processes times their size.
+    double threads = 0.0, demand = 0.0;
+    for (const PriorityProfile& profile : this->priorities) {
+        double share = profile.weight * std::max(1.0, profile.threads_per_process.mean());
+        threads += share;
+        demand += share * std::max(1.0, profile.cpu_bursts.mean()) * std::max(1.0, profile.cpu_burst.mean());
+    }
+    return threads == 0 ? 0.0 : demand / threads;
+}
+
+// Rounds a sampled value to a whole number of ticks of at least minimum.
+static SimTime to_ticks(double value, SimTime minimum) {
+    if (!(value < (double) SIM_TIME_MAX)) {
+        return SIM_TIME_MAX;
+    }
+    return std::max<SimTime>(minimum, std::llround(value));
+}
+
+// Rounds a sampled value to a count of at least 1.
+static size_t to_count(double value) {
+    return (size_t) std::min<SimTime>(to_ticks(value, 1), INT_MAX);
+}
+
+ThreadGenerator::ThreadGenerator(const GeneratorOptions& options, SimTime time_limit):
+    options(options), random(options.seed), time_limit(time_limit) {
+
+    double weights[4];
+    for (int p = 0; p < 4; ++p) {
+        weights[p] = options.priorities[p].weight;
+    }
+    if (weights[0] + weights[1] + weights[2] + weights[3] <= 0) {
+        std::cerr << "At least one priority must have a positive weight." << std::endl;
+        throw(std::logic_error("Bad generator options."));
+    }
+    this->priority = std::discrete_distribution<int>(std::begin(weights), std::end(weights));
+}
+
+bool ThreadGenerator::next(ThreadSpec& thread, std::vector<Burst>& bursts) {
+    if (this->num_generated == this->options.num_threads) {
+        return false;
+    }
+
+    // Start a new process once the current one has all its threads.
+    if (this->num_generated == this->current.first_thread + this->current.num_threads) {
+        this->current.process_id = (int) this->num_processes++;
+        this->current.priority = (ProcessPriority) this->priority(this->random);
+        this->current.first_thread = this->num_generated;
+
+        const PriorityProfile& profile = this->options.priorities[this->current.priority];
+        this->current.num_threads = std::min<size_t>(to_count(profile.threads_per_process.sample(this->random)),
+            this->options.num_threads - this->num_generated);
+    }
+
+    if (this->num_generated != 0 && !add_time(this->arrival_time, to_ticks(this->options.interarrival.sample(this->random), 0), this->arrival_time)) {
+        return false;
+    }
+    if (this->arrival_time > this->time_limit) {
+        return false;
+    }
+
+    const PriorityProfile& profile = this->options.priorities[this->current.priority];
+    thread.thread_id = (int) (this->num_generated - this->current.first_thread);
+    thread.process_id = this->current.process_id;
+    thread.priority = this->current.priority;
+    thread.process_index = this->num_processes - 1;
+    thread.arrival_time = this->arrival_time;
+    thread.first_burst = bursts.size();
+    thread.num_bursts = to_count(profile.cpu_bursts.sample(this->random)) * 2 - 1;
+
+    for (size_t b = 0; b < thread.num_bursts; ++b) {
+        if (b % 2 == 0) {
+            bursts.emplace_back(CPU, to_ticks(profile.cpu_burst.sample(this->random), 1));
+        } else {
+            bursts.emplace_back(IO, to_ticks(profile.io_burst.sample(this->random), 1));
+        }
+    }
+
+    this->num_generated++;
+    return true;
+}
+
+void ThreadGenerator::save(CheckpointWriter& writer) const {
+    std::ostringstream random_state;
+    random_state << this->random;
+
+    writer.write_string(random_state.str());
+    writer.write(this->current);
+    writer.write<uint64_t>(this->num_generated);
+    writer.write<uint64_t>(this->num_processes);
+    writer.write(this->arrival_time);
+}
+
+void ThreadGenerator::restore(CheckpointReader& reader) {
+    std::istringstream random_state(reader.read_string());
+    random_state >> this->random;
+    if (!random_state) {
+        reader.fail("bad random state");
+    }
+
+    this->current = reader.read<ProcessSpec>();
+    this->num_generated = reader.read<uint64_t>();
+    this->num_processes = reader.read<uint64_t>();
+    this->arrival_time = reader.read<SimTime>();
+}
+
+std::shared_ptr<const Workload> generate_workload(const GeneratorOptions& options) {
+    auto workload = std::make_shared<Workload>();
+    ThreadGenerator generator(options);
+
+    workload->thread_switch_overhead = options.thread_switch_overhead;
+    workload->process_switch_overhead = options.process_switch_overhead;
+    workload->threads.reserve(options.num_threads);
+
+    ThreadSpec thread;
+    while (generator.next(thread, workload->bursts)) {
+        if (thread.thread_id == 0) {
+            workload->processes.push_back(generator.process());
+        }
+        workload->threads.push_back(thread);
+    }
+
+    if (workload->threads.size() < options.num_threads) {
+        std::cerr << "Generated arrival times do not fit in the simulation's time type." << std::endl;
+        throw(std::logic_error("Bad generator options."));
+    }
+
+    workload->check_times();
+    workload->sort_arrivals();
+    return workload;
+}
@@ -0,0 +1,284 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types/enums.hpp"
+#include "types/workload/workload.hpp"
+#include "utilities/checkpoint/checkpoint.hpp"
+
+/*
+    DistributionKind:
+        The families of distributions the generator can draw from.
+*/
+enum DistributionKind {
+    CONSTANT,
+    UNIFORM,
+    EXPONENTIAL,
+    LOGNORMAL,
+    PARETO,
+    EMPIRICAL
+};
+
+/*
+    Distribution:
+        A distribution of non-negative values (times, lengths or counts). Written as a
+        string, as on the command line, it is one of:
+
+            const:V                 always V
+            uniform:LOW:HIGH        an integer uniformly drawn from [LOW, HIGH]
+            exp:MEAN                exponential with the given mean
+            lognormal:MU:SIGMA      e^X with X normal (MU, SIGMA)
+            pareto:SCALE:SHAPE      Pareto with minimum SCALE and tail index SHAPE
+            empirical:V@P,V@P,...   the piecewise-linear CDF through the points
+                                    (value, cumulative probability), e.g. measured
+                                    percentiles: empirical:2@0.5,10@0.9,80@0.99,400@1
+*/
+
+class Distribution {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        kind:
+            The family of the distribution.
+    */
+    DistributionKind kind = CONSTANT;
+
+    /*
+        a, b:
+            The parameters, in the order they are written in (see above).
+    */
+    double a = 0.0;
+    double b = 0.0;
+
+    /*
+        points:
+            For EMPIRICAL, the (value, cumulative probability) points of the CDF,
+            sorted, with the last probability 1.
+    */
+    std::vector<std::pair<double, double>> points;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    static Distribution constant(double value);
+
+    static Distribution uniform(double low, double high);
+
+    static Distribution exponential(double mean);
+
+    /*
+        parse(spec, distribution):
+            Parses a distribution written as above into distribution. Returns false
+            (leaving it unchanged) if spec is not valid.
+    */
+    static bool parse(const std::string& spec, Distribution& distribution);
+
+    /*
+        sample(random):
+            Draws a value.
+    */
+    double sample(std::mt19937_64& random) const;
+
+    /*
+        mean():
+            The expected value (infinite for a Pareto distribution with SHAPE <= 1).
+    */
+    double mean() const;
+};
+
+/*
+    PriorityProfile:
+        How the processes of one priority look.
+*/
+
+class PriorityProfile {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        weight:
+            The relative share of processes with this priority (0 for none).
+    */
+    double weight = 1.0;
+
+    /*
+        threads_per_process, cpu_bursts:
+            How many threads each process has and how many CPU bursts each thread
+            has (with an IO burst between each two). Both are at least 1.
+    */
+    Distribution threads_per_process = Distribution::constant(10);
+    Distribution cpu_bursts = Distribution::constant(5);
+
+    /*
+        cpu_burst, io_burst:
+            The length of each CPU and IO burst (at least 1).
+    */
+    Distribution cpu_burst = Distribution::uniform(1, 50);
+    Distribution io_burst = Distribution::uniform(1, 50);
+};
+
+/*
+    GeneratorOptions:
+        The shape of a synthetic workload.
+*/
+
+class GeneratorOptions {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        num_threads:
+            How many threads to generate.
+    */
+    size_t num_threads = 1000;
+
+    /*
+        interarrival:
+            The time between two thread arrivals.
+    */
+    Distribution interarrival = Distribution::uniform(0, 300);
+
+    /*
+        priorities:
+            The shape of the processes of each priority, indexed by ProcessPriority.
+    */
+    PriorityProfile priorities[4];
+
+    /*
+        thread_switch_overhead, process_switch_overhead:
+            The dispatch overheads of the workload.
+    */
+    SimTime thread_switch_overhead = 3;
+    SimTime process_switch_overhead = 7;
+
+    /*
+        seed:
+            The random seed. The same options always generate the same workload.
+    */
+    uint64_t seed = 1;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        set(key, value):
+            Sets one option by name, as given on the command line. The keys are
+            threads, seed, interarrival, thread_switch and process_switch, and the
+            per-priority weight, threads_per_process, cpu_bursts, cpu_burst and
+            io_burst, which set every priority, or only one when prefixed with its
+            name (e.g. batch.cpu_burst). Returns false if the key or value is invalid.
+    */
+    bool set(const std::string& key, const std::string& value);
+
+    /*
+        parse(list):
+            Sets every key=value option in a whitespace-separated list, e.g.
+            "threads=100000 seed=7 interarrival=exp:20 batch.cpu_burst=pareto:10:1.5".
+            Returns false if any of them is invalid.
+    */
+    bool parse(const std::string& list);
+
+    /*
+        mean_cpu_demand():
+            The expected total CPU time of a thread, over all priorities. Multiplied by
+            an arrival rate, it gives the offered load of an open system. Approximate,
+            as generated values are rounded to whole ticks.
+    */
+    double mean_cpu_demand() const;
+};
+
+/*
+    ThreadGenerator:
+        Generates the threads of a synthetic workload one at a time, in arrival order,
+        so that a simulation can take its arrivals from it as it goes instead of from a
+        workload generated up front. The threads are the same as generate_workload's.
+*/
+
+class ThreadGenerator {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        ThreadGenerator(options, time_limit):
+            Starts generating the workload described by options. No thread arrives
+            after time_limit. Throws std::logic_error if no priority has a weight.
+    */
+    ThreadGenerator(const GeneratorOptions& options, SimTime time_limit = SIM_TIME_MAX);
+
+    /*
+        next(thread, bursts):
+            Generates the next thread into thread and appends its bursts to bursts
+            (thread.first_burst is their index there). Returns false once
+            options.num_threads threads have been generated or the next one would
+            arrive after the time limit.
+    */
+    bool next(ThreadSpec& thread, std::vector<Burst>& bursts);
+
+    /*
+        process():
+            The process of the last generated thread. Its num_threads is final as
+            soon as its first thread has been generated.
+    */
+    const ProcessSpec& process() const { return current; }
+
+    /*
+        save(writer), restore(reader):
+            Save how far the generator has got (its random state and position) in a
+            checkpoint, and continue from there in a generator made with the same
+            options. The threads generated after restore() are the same as they would
+            have been after save().
+    */
+    void save(CheckpointWriter& writer) const;
+
+    void restore(CheckpointReader& reader);
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    GeneratorOptions options;
+    std::mt19937_64 random;
+    std::discrete_distribution<int> priority;
+    ProcessSpec current;
+    size_t num_generated = 0;
+    size_t num_processes = 0;
+    SimTime arrival_time = 0;
+    SimTime time_limit;
+};
+
+/*
+    generate_workload(options):
+        Builds a random workload of the given shape: processes get a priority drawn by
+        weight, and threads arrive one after another, interarrival apart, those of a
+        process consecutively. Workloads of any size can be simulated this way without
+        simulation files. Throws std::logic_error if the workload's times do not fit in
+        SimTime (see Workload::check_times).
+*/
+std::shared_ptr<const Workload> generate_workload(const GeneratorOptions& options);
+
+#endif
@@ -1,10 +1,13 @@
 #include "utilities/logger/logger.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <memory>
 #include <sstream>
 #include <iostream>
 
+#include "types/enums.hpp"
 #include "types/thread/thread.hpp"
 #include "types/event/event.hpp"
 #include "types/process/process.hpp"
@@ -12,35 +15,7 @@
 
 #include "utilities/fmt/format.h"
 
-inline const char* STATE_MAP[5] = {
-    "NEW",
-    "READY",
-    "RUNNING",
-    "BLOCKED",
-    "EXIT"
-};
-
-
-inline const char* PROCESS_PRIORITY_MAP[4] = {
-    "SYSTEM",
-    "INTERACTIVE",
-    "NORMAL",
-    "BATCH"
-};
-
-
-inline const char* EVENT_MAP[8] = {
-    "THREAD_ARRIVED",
-    "THREAD_DISPATCH_COMPLETED",
-    "PROCESS_DISPATCH_COMPLETED",
-    "CPU_BURST_COMPLETED",
-    "IO_BURST_COMPLETED",
-    "THREAD_COMPLETED",
-    "THREAD_PREEMPTED",
-    "DISPATCHER_INVOKED"
-};
-
-void Logger::print_state_transition(const std::shared_ptr<Event> event, ThreadState before_state, ThreadState after_state) const {
+void Logger::print_state_transition(const Event& event, ThreadState before_state, ThreadState after_state) const {
     /*
     This (along with print_verbose) prints something like this:
 
@@ -50,26 +25,36 @@ void Logger::print_state_transition(const std::shared_ptr<Event> event, ThreadSt
         Transitioned from NEW to READY
     */
 
-    std::string message = fmt::format("Transitioned from {} to {}", STATE_MAP[before_state], STATE_MAP[after_state]);
+    const Thread* thread = event.thread;
 
-    print_verbose(event, event->thread, message);
+    if (!this->wants_verbose(event, thread)){
+        return;
+    }
+
+    // Formatted in one go rather than through print_verbose, as this runs for most events.
+    fmt::memory_buffer message;
+    fmt::format_to(message, "At time {}:\n    {}\n    Thread {} in process {} [{}]\n    Transitioned from {} to {}\n\n",
+        event.time, EVENT_TYPE_NAMES[event.type], thread->thread_id, thread->process_id, PROCESS_PRIORITY_NAMES[thread->priority],
+        THREAD_STATE_NAMES[before_state], THREAD_STATE_NAMES[after_state]);
+
+    this->output->write(message.data(), message.size());
 }
 
 
-void Logger::print_verbose(const std::shared_ptr<Event> event, std::shared_ptr<Thread> thread, std::string message) const {
-    if (!this->verbose){
+void Logger::print_verbose(const Event& event, const Thread* thread, const std::string& message) const {
+    if (!this->wants_verbose(event, thread)){
         return;
     }
 
-    std::string verbose_message = fmt::format("At time {}:\n", event->time);
-    verbose_message += fmt::format("    {}\n", EVENT_MAP[event->type]);
-    verbose_message += fmt::format("    Thread {} in process {} [{}]\n", thread->thread_id, thread->process_id, PROCESS_PRIORITY_MAP[thread->priority]);
-    verbose_message += fmt::format("    {}\n\n", message);
+    // One formatting call and one write per message: this runs for every event.
+    fmt::memory_buffer verbose_message;
+    fmt::format_to(verbose_message, "At time {}:\n    {}\n    Thread {} in process {} [{}]\n    {}\n\n",
+        event.time, EVENT_TYPE_NAMES[event.type], thread->thread_id, thread->process_id, PROCESS_PRIORITY_NAMES[thread->priority], message);
 
-    std::cout << verbose_message;
+    this->output->write(verbose_message.data(), verbose_message.size());
 }
 
-void Logger::print_per_thread_metrics(std::shared_ptr<Process> process) const {
+void Logger::print_per_thread_metrics(const Process* process) const {
     /*
     This prints something like this:
 
@@ -83,12 +68,22 @@ void Logger::print_per_thread_metrics(std::shared_ptr<Process> process) const {
         return;
     }
 
+    // A run stopped early has threads that have not arrived or exited yet, which
+    // are left out, along with processes that have no exited thread.
+    auto exited = [](const Thread* thread) { return thread != nullptr && thread->current_state == EXIT; };
+    if (!process->threads.empty() && std::none_of(process->threads.begin(), process->threads.end(), exited)) {
+        return;
+    }
+
     std::string message;
 
-    message = fmt::format("Process {} [{}]:\n", process->process_id, PROCESS_PRIORITY_MAP[process->priority]);
-    std::cout << message;
+    message = fmt::format("Process {} [{}]:\n", process->process_id, PROCESS_PRIORITY_NAMES[process->priority]);
+    *this->output << message;
 
     for (auto thread : process->threads) {
+        if (!exited(thread)) {
+            continue;
+        }
 
         std::string thread_message;
 
@@ -98,13 +93,35 @@ void Logger::print_per_thread_metrics(std::shared_ptr<Process> process) const {
         thread_message += fmt::format("I/O: {:<6} ", thread->io_time);
         thread_message += fmt::format("TRT: {:<6} ", thread->turnaround_time());
         thread_message += fmt::format("END: {:<6}\n", thread->end_time);
-        std::cout << thread_message;
+        *this->output << thread_message;
+    }
+    *this->output << "\n";
+}
+
+void Logger::print_thread_summary(const Thread* thread) const {
+    /*
+    This prints something like this:
+
+    Thread  0 in process 1 [SYSTEM]:    ARR: 5      CPU: 8      I/O: 3      TRT: 92     END: 97
+    */
+
+    if (!this->per_thread) {
+        return;
     }
-    std::cout << "\n";
+
+    std::string message;
+
+    message = fmt::format("Thread {:>2} in process {} [{}]:    ", thread->thread_id, thread->process_id, PROCESS_PRIORITY_NAMES[thread->priority]);
+    message += fmt::format("ARR: {:<6} ", thread->arrival_time);
+    message += fmt::format("CPU: {:<6} ", thread->service_time);
+    message += fmt::format("I/O: {:<6} ", thread->io_time);
+    message += fmt::format("TRT: {:<6} ", thread->turnaround_time());
+    message += fmt::format("END: {:<6}\n", thread->end_time);
+    *this->output << message;
 }
 
 
-void Logger::print_simulation_metrics(SystemStats stats) const {
+void Logger::print_simulation_metrics(const SystemStats& stats) const {
     /*
     This prints something like this:
 
@@ -139,18 +156,21 @@ void Logger::print_simulation_metrics(SystemStats stats) const {
     */
 
     if (!this->metrics) {
+        if (this->latency) {
+            print_latency_percentiles(stats);
+        }
         return;
     }
 
     for (int i = SYSTEM; i <= BATCH; ++i) {
         std::string process_type_message;
 
-        process_type_message = fmt::format("{} THREADS:\n", PROCESS_PRIORITY_MAP[i]);
+        process_type_message = fmt::format("{} THREADS:\n", PROCESS_PRIORITY_NAMES[i]);
         process_type_message += fmt::format("    {:<22} {:>8}\n", "Total Count:", stats.thread_counts[i]);
         process_type_message += fmt::format("    {:<22} {:>8.{}f}\n", "Avg. response time:", stats.avg_thread_response_times[i], 2);
         process_type_message += fmt::format("    {:<22} {:>8.{}f}\n\n", "Avg. turnaround time:", stats.avg_thread_turnaround_times[i], 2);
 
-        std::cout << process_type_message;
+        *this->output << process_type_message;
     }
 
     std::string summary_message;
@@ -165,5 +185,347 @@ void Logger::print_simulation_metrics(SystemStats stats) const {
     summary_message += fmt::format("{:<22}{:>11.{}f}%\n", "CPU utilization:", stats.cpu_utilization, 2);
     summary_message += fmt::format("{:<22}{:>11.{}f}%\n", "CPU efficiency:", stats.cpu_efficiency, 2);
 
-    std::cout << summary_message << std::endl;
+    *this->output << summary_message << std::endl;
+
+    if (this->latency) {
+        print_latency_percentiles(stats);
+    }
+}
+
+
+void Logger::print_latency_percentiles(const SystemStats& stats) const {
+    /*
+    This prints something like this for each priority:
+
+    SYSTEM LATENCY:                  p50      p90      p99    p99.9      max
+        Response time:                 9       31       45       45       45
+        Turnaround time:              83      112      130      130      130
+        Ready queue wait:              4       22       38       38       38
+        Burst wait:                    6       27       41       41       41
+    */
+
+    auto format_row = [](const char* label, const LatencyHistogram& histogram) {
+        return fmt::format("    {:<22}{:>9}{:>9}{:>9}{:>9}{:>9}\n", label,
+            histogram.percentile(50), histogram.percentile(90), histogram.percentile(99),
+            histogram.percentile(99.9), histogram.max());
+    };
+
+    std::string message;
+
+    for (int i = SYSTEM; i <= BATCH; ++i) {
+        message += fmt::format("{:<26}{:>9}{:>9}{:>9}{:>9}{:>9}\n", fmt::format("{} LATENCY:", PROCESS_PRIORITY_NAMES[i]),
+            "p50", "p90", "p99", "p99.9", "max");
+        message += format_row("Response time:", stats.response_time_histograms[i]);
+        message += format_row("Turnaround time:", stats.turnaround_time_histograms[i]);
+        message += format_row("Ready queue wait:", stats.ready_wait_histograms[i]);
+        message += format_row("Burst wait:", stats.burst_wait_histograms[i]);
+        message += "\n";
+    }
+
+    *this->output << message;
+}
+
+void Logger::print_comparison(const std::vector<std::string>& algorithms, const std::vector<SystemStats>& stats, size_t baseline) const {
+    /*
+    This prints something like this (one column per algorithm):
+
+    Comparison against FCFS:
+                                      FCFS                      RR
+    SYSTEM THREADS:
+        Total Count:                     3                       3 (+0.00%)
+        Avg. response time:          23.33                   12.00 (-48.56%)
+    ...
+    */
+
+    auto format_row = [&](const std::string& label, auto value_of, int decimals) {
+        std::string row = fmt::format("{:<26}", label);
+        double base = (double) value_of(stats[baseline]);
+
+        for (size_t i = 0; i < stats.size(); ++i) {
+            double value = (double) value_of(stats[i]);
+            std::string delta;
+
+            if (i != baseline) {
+                if (base != 0.0) {
+                    delta = fmt::format("({:+.2f}%)", (value - base) / base * 100.0);
+                } else {
+                    delta = (value == 0.0) ? "(+0.00%)" : "(n/a)";
+                }
+            }
+            row += fmt::format("{:>12.{}f} {:<11}", value, decimals, delta);
+        }
+        return row + "\n";
+    };
+
+    std::string message = fmt::format("Comparison against {}:\n", algorithms[baseline]);
+    message += fmt::format("{:<26}", "");
+    for (const std::string& algorithm : algorithms) {
+        message += fmt::format("{:>12} {:<11}", algorithm, "");
+    }
+    message += "\n";
+
+    for (int p = SYSTEM; p <= BATCH; ++p) {
+        message += fmt::format("{} THREADS:\n", PROCESS_PRIORITY_NAMES[p]);
+        message += format_row("    Total Count:", [p](const SystemStats& s) { return s.thread_counts[p]; }, 0);
+        message += format_row("    Avg. response time:", [p](const SystemStats& s) { return s.avg_thread_response_times[p]; }, 2);
+        message += format_row("    Avg. turnaround time:", [p](const SystemStats& s) { return s.avg_thread_turnaround_times[p]; }, 2);
+        message += "\n";
+    }
+
+    message += format_row("Total elapsed time:", [](const SystemStats& s) { return s.total_time; }, 0);
+    message += format_row("Total service time:", [](const SystemStats& s) { return s.service_time; }, 0);
+    message += format_row("Total I/O time:", [](const SystemStats& s) { return s.io_time; }, 0);
+    message += format_row("Total dispatch time:", [](const SystemStats& s) { return s.dispatch_time; }, 0);
+    message += format_row("Total idle time:", [](const SystemStats& s) { return s.total_idle_time; }, 0);
+    message += "\n";
+    message += format_row("CPU utilization (%):", [](const SystemStats& s) { return s.cpu_utilization; }, 2);
+    message += format_row("CPU efficiency (%):", [](const SystemStats& s) { return s.cpu_efficiency; }, 2);
+
+    *this->output << message << std::endl;
+}
+
+void Logger::print_steady_state(const SteadyStateReport& report, double offered_load) const {
+    /*
+    This prints something like this:
+
+    STEADY STATE:
+        Offered load:                       80.00%
+        Threads exited:                     39874
+        Warm-up (MSER):                       415 threads, until time 10432
+        Batches:                               20 of 1972 threads
+                                             mean  95% CI +/-
+        Response time:                      35.21        2.10
+        Turnaround time:                   412.77       18.35
+        p99 turnaround time:              1630.40      120.72
+        Throughput (/1000 ticks):           39.87        0.42
+        CPU utilization (%):                79.61        0.88
+
+    or, without a steady state, a warning in place of the warm-up and batches.
+    */
+
+    std::string message = "STEADY STATE:\n";
+    message += fmt::format("    {:<30}{:>10.2f}%\n", "Offered load:", offered_load);
+    message += fmt::format("    {:<30}{:>10}\n", "Threads exited:", report.num_samples);
+
+    if (!report.stable) {
+        message += fmt::format("    Unstable, no steady state: {}.\n"
+                               "    The metrics grow with the length of the run, so no confidence intervals are given.\n\n", report.instability);
+        *this->output << message;
+        return;
+    }
+
+    message += fmt::format("    {:<30}{:>10} threads, until time {}\n",
+        report.warmup_detected ? "Warm-up (MSER):" : "Warm-up:", report.warmup_samples, report.warmup_time);
+
+    if (report.num_batches < 2) {
+        message += "    Too few threads exited to estimate the steady state.\n\n";
+        *this->output << message;
+        return;
+    }
+
+    message += fmt::format("    {:<30}{:>10} of {} threads\n", "Batches:", report.num_batches, report.batch_size);
+    message += fmt::format("    {:<30}{:>10}{:>12}\n", "", "mean", "95% CI +/-");
+
+    auto format_row = [](const char* label, const ConfidenceInterval& interval) {
+        return fmt::format("    {:<30}{:>10.2f}{:>12.2f}\n", label, interval.mean, interval.half_width);
+    };
+    message += format_row("Response time:", report.response_time);
+    message += format_row("Turnaround time:", report.turnaround_time);
+    message += format_row("p99 turnaround time:", report.p99_turnaround_time);
+    message += format_row("Throughput (/1000 ticks):", report.throughput);
+    message += format_row("CPU utilization (%):", report.utilization);
+    message += "\n";
+
+    *this->output << message;
+}
+
+void Logger::print_profile(const Profiler& profiler) const {
+    /*
+    This prints something like this:
+
+    SIMULATOR PROFILE:
+        Event type                      Count    Total ms     ns/event   Allocs
+        THREAD_ARRIVED                      7       0.012       1714.3        0
+        ...
+        Event loop                       1005       0.310        308.5        0
+
+        Event queue high-water mark:        9
+        Scheduler adds:                   320
+        Scheduler picks:                  321 (142.1 ns/call)
+    */
+
+    std::string message = "SIMULATOR PROFILE:\n";
+    message += fmt::format("    {:<28}{:>9}{:>12}{:>13}{:>9}\n", "Event type", "Count", "Total ms", "ns/event", "Allocs");
+
+    uint64_t total_events = 0;
+    uint64_t total_allocations = 0;
+
+    for (int i = THREAD_ARRIVED; i <= DISPATCHER_INVOKED; ++i) {
+        double ns = profiler.ticks_to_ns(profiler.handler_ticks[i]);
+        uint64_t count = profiler.event_counts[i];
+
+        message += fmt::format("    {:<28}{:>9}{:>12.3f}{:>13.1f}{:>9}\n", EVENT_TYPE_NAMES[i], count, ns / 1e6,
+            count == 0 ? 0.0 : ns / count, profiler.handler_allocations[i]);
+
+        total_events += count;
+        total_allocations += profiler.handler_allocations[i];
+    }
+
+    message += fmt::format("    {:<28}{:>9}{:>12.3f}{:>13.1f}{:>9}\n\n", "Event loop", total_events,
+        profiler.total_ns / 1e6, total_events == 0 ? 0.0 : (double) profiler.total_ns / total_events, total_allocations);
+
+    message += fmt::format("    {:<30}{:>9}\n", "Event queue high-water mark:", profiler.queue_high_water);
+    message += fmt::format("    {:<30}{:>9}\n", "Scheduler adds:", profiler.scheduler_adds);
+    message += fmt::format("    {:<30}{:>9} ({:.1f} ns/call)\n", "Scheduler picks:", profiler.scheduler_picks,
+        profiler.scheduler_picks == 0 ? 0.0 : profiler.ticks_to_ns(profiler.scheduler_pick_ticks) / profiler.scheduler_picks);
+
+    *this->output << message << std::endl;
+}
+
+// Appends a JSON string literal for value.
+static void append_json_string(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    fmt::format_to(std::back_inserter(out), "\\u{:04x}", (int) c);
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+// Appends a JSON number for value, or null if it is not finite (JSON has no NaN).
+static void append_json_number(std::string& out, double value) {
+    if (std::isfinite(value)) {
+        fmt::format_to(std::back_inserter(out), "{}", value);
+    } else {
+        out += "null";
+    }
+}
+
+static void append_json_percentiles(std::string& out, const char* name, const LatencyHistogram& histogram) {
+    fmt::format_to(std::back_inserter(out),
+        "\"{}\": {{\"count\": {}, \"p50\": {}, \"p90\": {}, \"p99\": {}, \"p99.9\": {}, \"max\": {}}}",
+        name, histogram.total_count(), histogram.percentile(50), histogram.percentile(90),
+        histogram.percentile(99), histogram.percentile(99.9), histogram.max());
+}
+
+// Appends the options that change the results of a run, so the run can be reproduced.
+static void append_json_options(std::string& out, const FlagOptions& options) {
+    auto it = std::back_inserter(out);
+    out += "{\"generate\": ";
+    append_json_string(out, options.generate);
+    fmt::format_to(it, ", \"retire\": {}, \"max_time\": {}, \"max_events\": {}, "
+        "\"max_completed\": {}, \"converge\": ", options.retire,
+        options.max_time, options.max_events, options.max_completed);
+    append_json_number(out, options.converge);
+    out += ", \"arrival_rate\": ";
+    append_json_number(out, options.arrival_rate);
+    fmt::format_to(it, ", \"duration\": {}, \"warmup\": {}, \"batches\": {}, \"branch_at\": {}, \"restore\": ",
+        options.duration, options.warmup, options.batches, options.branch_at);
+    append_json_string(out, options.restore_file);
+    out += "}";
+}
+
+void Logger::print_json_report(const SystemStats& stats, const RunInfo& info, const SteadyStateReport* steady_state) const {
+    std::string message;
+    format_json_report(message, stats, info, steady_state);
+    *this->output << message << "\n";
+}
+
+void Logger::format_json_report(std::string& out, const SystemStats& stats, const RunInfo& info,
+                                const SteadyStateReport* steady_state) {
+    /*
+    This produces something like this (on one line):
+
+    {"run": {"file": "input-1", "algorithm": "FCFS", ...},
+     "totals": {"elapsed_time": 130, ...},
+     "priorities": {"SYSTEM": {"count": 3, "avg_response_time": 23.33, ...}, ...}}
+    */
+
+    auto it = std::back_inserter(out);
+
+    out += "{\"run\": {\"file\": ";
+    append_json_string(out, info.filename);
+    out += ", \"algorithm\": ";
+    append_json_string(out, info.algorithm);
+    fmt::format_to(it, ", \"time_slice\": {}, \"options\": ", info.time_slice);
+    append_json_options(out, info.options);
+    fmt::format_to(it, ", \"processes\": {}, \"threads\": {}, \"events\": {}, "
+        "\"wall_time_ns\": {}, \"event_loop_allocations\": {}, \"arena_bytes\": {}, \"stop_reason\": ",
+        info.num_processes, info.num_threads, info.events_processed,
+        info.wall_time_ns, info.event_loop_allocations, info.arena_bytes);
+    if (info.stop_reason.empty()) {
+        out += "null";
+    } else {
+        append_json_string(out, info.stop_reason);
+    }
+    out += "}, ";
+
+    fmt::format_to(it, "\"totals\": {{\"elapsed_time\": {}, \"service_time\": {}, \"io_time\": {}, "
+        "\"dispatch_time\": {}, \"idle_time\": {}, \"cpu_time\": {}, \"cpu_utilization\": ",
+        stats.total_time, stats.service_time, stats.io_time, stats.dispatch_time,
+        stats.total_idle_time, stats.total_cpu_time);
+    append_json_number(out, stats.cpu_utilization);
+    out += ", \"cpu_efficiency\": ";
+    append_json_number(out, stats.cpu_efficiency);
+    out += "}, \"priorities\": {";
+
+    for (int i = SYSTEM; i <= BATCH; ++i) {
+        fmt::format_to(it, "{}\"{}\": {{\"count\": {}, \"avg_response_time\": ",
+            i == SYSTEM ? "" : ", ", PROCESS_PRIORITY_NAMES[i], stats.thread_counts[i]);
+        append_json_number(out, stats.avg_thread_response_times[i]);
+        out += ", \"avg_turnaround_time\": ";
+        append_json_number(out, stats.avg_thread_turnaround_times[i]);
+        fmt::format_to(it, ", \"total_response_time\": {}, \"total_turnaround_time\": {}, ",
+            stats.total_thread_response_times[i], stats.total_thread_turnaround_times[i]);
+
+        append_json_percentiles(out, "response_time", stats.response_time_histograms[i]);
+        out += ", ";
+        append_json_percentiles(out, "turnaround_time", stats.turnaround_time_histograms[i]);
+        out += ", ";
+        append_json_percentiles(out, "ready_wait", stats.ready_wait_histograms[i]);
+        out += ", ";
+        append_json_percentiles(out, "burst_wait", stats.burst_wait_histograms[i]);
+        out += "}";
+    }
+    out += "}";
+
+    if (steady_state != nullptr) {
+        auto append_interval = [&](const char* name, const ConfidenceInterval& interval) {
+            fmt::format_to(it, ", \"{}\": {{\"mean\": ", name);
+            append_json_number(out, interval.mean);
+            out += ", \"half_width\": ";
+            append_json_number(out, interval.half_width);
+            out += "}";
+        };
+
+        fmt::format_to(it, ", \"steady_state\": {{\"samples\": {}, \"warmup_samples\": {}, \"warmup_time\": {}, "
+            "\"warmup_detected\": {}, \"end_time\": {}, \"batches\": {}, \"batch_size\": {}",
+            steady_state->num_samples, steady_state->warmup_samples, steady_state->warmup_time,
+            steady_state->warmup_detected ? "true" : "false", steady_state->end_time,
+            steady_state->num_batches, steady_state->batch_size);
+        if (steady_state->stable) {
+            out += ", \"stable\": true";
+            append_interval("response_time", steady_state->response_time);
+            append_interval("turnaround_time", steady_state->turnaround_time);
+            append_interval("p99_turnaround_time", steady_state->p99_turnaround_time);
+            append_interval("throughput", steady_state->throughput);
+            append_interval("utilization", steady_state->utilization);
+        } else {
+            out += ", \"stable\": false, \"instability\": ";
+            append_json_string(out, steady_state->instability);
+        }
+        out += "}";
+    }
+
+    out += "}";
 }
@@ -1,12 +1,18 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 #include "types/event/event.hpp"
+#include "types/run_info/run_info.hpp"
 #include "types/process/process.hpp"
 #include "types/thread/thread.hpp"
 #include "types/system_stats/system_stats.hpp"
+#include "utilities/profiler/profiler.hpp"
+#include "utilities/steady_state/steady_state.hpp"
+#include "utilities/verbose_filter/verbose_filter.hpp"
 
 /*
     Logger:
@@ -45,6 +51,30 @@ public:
     */
     bool metrics;
 
+    /*
+        latency:
+            Whether to display latency percentiles (p50, p90, p99, p99.9, max) per
+            priority along with the simulation metrics.
+
+            Set with the -l, --latency flag in the command line.
+    */
+    bool latency = false;
+
+    /*
+        filter:
+            Which blocks of the verbose output to print.
+
+            Set with the --filter_* flags in the command line.
+    */
+    VerboseFilter filter;
+
+    /*
+        output:
+            Where everything is printed. Defaults to standard output; simulations run
+            side by side (e.g. by cpu-sim-golden) each print to their own stream.
+    */
+    std::ostream* output = &std::cout;
+
     //==================================================
     //  Member functions
     //==================================================
@@ -56,10 +86,20 @@ public:
     Logger() {}
 
     /*
-        Logger(verbose, per_thread, metrics):
+        Logger(verbose, per_thread, metrics, latency, filter):
             Constructs a new logger object with the input parameters.
     */
-    Logger(bool verbose, bool per_thread, bool metrics) : verbose(verbose), per_thread(per_thread), metrics(metrics) {}
+    Logger(bool verbose, bool per_thread, bool metrics, bool latency = false, const VerboseFilter& filter = VerboseFilter()) :
+        verbose(verbose), per_thread(per_thread), metrics(metrics), latency(latency), filter(filter) {}
+
+    /*
+        wants_verbose(event, thread):
+            Whether a verbose block for event, about thread, would be printed. Lets
+            callers skip building the block's message when it would not be.
+    */
+    bool wants_verbose(const Event& event, const Thread* thread) const {
+        return this->verbose && this->filter.matches(event, thread);
+    }
 
     /*
         print_state_transition(event, before_state, after_state):
@@ -67,28 +107,84 @@ public:
             that the thread associated with the given event has transitioned from
             before_state to after_state.
     */
-    void print_state_transition(const std::shared_ptr<Event> event, ThreadState before_state, ThreadState after_state) const;
+    void print_state_transition(const Event& event, ThreadState before_state, ThreadState after_state) const;
 
     /*
         print_verbose(event, thread, message):
             Outputs the given message if verbose is true. Helper function for
             print_state_transition.
     */
-    void print_verbose(const std::shared_ptr<Event> event, std::shared_ptr<Thread> thread, std::string message) const;
+    void print_verbose(const Event& event, const Thread* thread, const std::string& message) const;
 
     /*
         print_per_thread_metrics(process):
             If per_thread is set to true, outputs detailed information
             about a process and its threads.
     */
-    void print_per_thread_metrics(std::shared_ptr<Process> process) const;
+    void print_per_thread_metrics(const Process* process) const;
+
+    /*
+        print_thread_summary(thread):
+            If per_thread is set to true, outputs the metrics of a single thread on
+            one line, including its process. Used for threads that are freed when they
+            exit, so there is nothing left to print per process at the end.
+    */
+    void print_thread_summary(const Thread* thread) const;
 
     /*
         print_simulation_metrics(stats):
             If metrics is set to true, outputs general simulation metrics
-            contained in a SystemStats object.
+            contained in a SystemStats object. If latency is set to true, also
+            outputs the latency percentiles from its histograms.
+    */
+    void print_simulation_metrics(const SystemStats& stats) const;
+
+    /*
+        print_latency_percentiles(stats):
+            Outputs p50/p90/p99/p99.9/max of the response, turnaround, ready queue wait
+            and burst wait histograms in a SystemStats object, per priority.
+    */
+    void print_latency_percentiles(const SystemStats& stats) const;
+
+    /*
+        print_comparison(algorithms, stats, baseline):
+            Outputs the metrics of several runs of the same workload side by side, one
+            column per algorithm, with each value's relative difference to the run at
+            index `baseline`.
+    */
+    void print_comparison(const std::vector<std::string>& algorithms, const std::vector<SystemStats>& stats, size_t baseline) const;
+
+    /*
+        print_profile(profiler):
+            Outputs the simulator's own performance counters.
+    */
+    void print_profile(const Profiler& profiler) const;
+
+    /*
+        print_steady_state(report, offered_load):
+            Outputs the steady-state metrics of an open-system run with their 95%
+            confidence intervals, and the offered load (in percent) for comparison
+            with the measured utilization. The offered load only counts CPU bursts:
+            dispatch overheads come on top of it. An unstable run gets a warning
+            instead of the confidence intervals.
+    */
+    void print_steady_state(const SteadyStateReport& report, double offered_load) const;
+
+    /*
+        print_json_report(stats, info, steady_state):
+            Outputs the statistics and the run information as a single JSON document,
+            regardless of the other output flags. The steady-state metrics of an open
+            system are included if given.
+    */
+    void print_json_report(const SystemStats& stats, const RunInfo& info, const SteadyStateReport* steady_state = nullptr) const;
+
+    /*
+        format_json_report(out, stats, info, steady_state):
+            Appends the JSON document printed by print_json_report to out, so that
+            callers reporting many runs can reuse one buffer.
     */
-    void print_simulation_metrics(SystemStats stats) const;
+    static void format_json_report(std::string& out, const SystemStats& stats, const RunInfo& info,
+                                   const SteadyStateReport* steady_state = nullptr);
 };
 
 #endif
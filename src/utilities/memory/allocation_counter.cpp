@@ -0,0 +1,89 @@
+#include "utilities/memory/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> allocations(0);
+static std::atomic<size_t> bytes(0);
+
+size_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+size_t allocated_bytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+static void* counted_allocate(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+static void* counted_allocate_aligned(size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+
+    size_t align = static_cast<size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment.
+    size_t rounded = (size + align - 1) / align * align;
+    void* memory = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(size_t size) {
+    return counted_allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return counted_allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
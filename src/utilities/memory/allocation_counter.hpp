@@ -0,0 +1,30 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+/*
+    Allocation counter:
+        The program replaces the global operator new/delete with versions that count
+        how many heap allocations have been made. Reading the counter before and after
+        a piece of work tells us how many times that work hit the allocator, which is
+        how we check that the simulation's event loop runs without allocating once it
+        has warmed up.
+
+        The counters are relaxed atomics, so they are safe to read from any thread and
+        add next to nothing to the cost of an allocation.
+*/
+
+/*
+    allocation_count():
+        The number of heap allocations made by the program so far.
+*/
+size_t allocation_count();
+
+/*
+    allocated_bytes():
+        The total number of bytes requested from the heap so far.
+*/
+size_t allocated_bytes();
+
+#endif
@@ -0,0 +1,67 @@
+#include "utilities/memory/arena.hpp"
+
+#include <cstdint>
+#include <new>
+
+Arena::Arena(size_t initial_chunk_size) : next_chunk_size(initial_chunk_size) {}
+
+Arena::~Arena() {
+    while (chunks != nullptr) {
+        Chunk* next = chunks->next;
+        ::operator delete(chunks);
+        chunks = next;
+    }
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    if (cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        add_chunk(bytes + alignment);
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    allocated += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::add_chunk(size_t min_bytes) {
+    size_t size = next_chunk_size;
+    while (size < min_bytes + sizeof(Chunk)) {
+        size *= 2;
+    }
+    next_chunk_size = size * 2;
+
+    Chunk* chunk = static_cast<Chunk*>(::operator new(size));
+    chunk->next = chunks;
+    chunk->size = size;
+    chunks = chunk;
+
+    cursor = reinterpret_cast<char*>(chunk + 1);
+    limit = reinterpret_cast<char*>(chunk) + size;
+    reserved += size;
+    chunks_requested++;
+}
+
+void Arena::release() {
+    // Keep the largest chunk (the newest one, since sizes only grow) for the next run.
+    Chunk* keep = chunks;
+    if (keep == nullptr) {
+        return;
+    }
+
+    Chunk* chunk = keep->next;
+    while (chunk != nullptr) {
+        Chunk* next = chunk->next;
+        ::operator delete(chunk);
+        chunk = next;
+    }
+
+    keep->next = nullptr;
+    chunks = keep;
+    cursor = reinterpret_cast<char*>(keep + 1);
+    limit = reinterpret_cast<char*>(keep) + keep->size;
+    reserved = keep->size;
+    allocated = 0;
+}
@@ -0,0 +1,154 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+/*
+    Arena:
+        A monotonic memory resource for objects that live for a whole simulation run.
+
+        Allocations are carved out of large chunks by bumping a pointer, and individual
+        deallocations are ignored. Everything is given back at once by release(), so
+        tearing down a run with millions of threads costs a handful of frees instead of
+        one per object. Because nothing is destroyed individually, only objects that do
+        not need their destructors run (or whose only resources also live in the arena)
+        should be placed here.
+
+        The arena is a std::pmr::memory_resource, so standard containers can use it
+        through std::pmr allocators.
+*/
+
+class Arena : public std::pmr::memory_resource {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        Arena(initial_chunk_size):
+            Creates an empty arena. The first chunk is requested on the first allocation,
+            and each later chunk is twice as large as the one before it.
+    */
+    explicit Arena(size_t initial_chunk_size = 64 * 1024);
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    /*
+        ~Arena():
+            Frees every chunk, including the one kept by release().
+    */
+    ~Arena();
+
+    /*
+        create<T>(args...):
+            Constructs a T inside the arena and returns a pointer to it.
+    */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    /*
+        allocate_array<T>(count):
+            Returns uninitialized storage for `count` objects of type T. The caller is
+            responsible for constructing them (e.g. with placement new).
+    */
+    template <typename T>
+    T* allocate_array(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /*
+        release():
+            Gives back all memory handed out so far in one shot. The largest chunk is
+            kept (and reused by the next run) so that repeated runs over similar
+            workloads do not have to go back to the system allocator.
+    */
+    void release();
+
+    /*
+        bytes_allocated():
+            The number of bytes handed out since the last release().
+    */
+    size_t bytes_allocated() const { return allocated; }
+
+    /*
+        bytes_reserved():
+            The total size of the chunks the arena currently holds.
+    */
+    size_t bytes_reserved() const { return reserved; }
+
+    /*
+        chunk_count():
+            The number of chunks the arena has requested from the system allocator
+            over its lifetime. Useful to check that steady-state work is not growing it.
+    */
+    size_t chunk_count() const { return chunks_requested; }
+
+protected:
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+
+    /*
+        Chunk:
+            Header at the start of every chunk; the usable memory follows it.
+    */
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        chunks:
+            Singly linked list of chunks, newest first. The newest chunk is the one
+            currently being carved up.
+    */
+    Chunk* chunks = nullptr;
+
+    /*
+        cursor, limit:
+            The free region of the current chunk.
+    */
+    char* cursor = nullptr;
+    char* limit = nullptr;
+
+    /*
+        next_chunk_size:
+            The size of the next chunk to request.
+    */
+    size_t next_chunk_size;
+
+    size_t allocated = 0;
+    size_t reserved = 0;
+    size_t chunks_requested = 0;
+
+    /*
+        add_chunk(min_bytes):
+            Requests a new chunk that can hold at least min_bytes (plus alignment slack).
+    */
+    void add_chunk(size_t min_bytes);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "utilities/microbench/microbench.hpp"
+
+#include <utility>
+
+// Function-local so registration works from any file's static initializers.
+static std::vector<std::pair<std::string, Microbenchmark>>& registry() {
+    static std::vector<std::pair<std::string, Microbenchmark>> benchmarks;
+    return benchmarks;
+}
+
+bool register_microbenchmark(const std::string& name, Microbenchmark benchmark) {
+    registry().emplace_back(name, benchmark);
+    return true;
+}
+
+std::vector<MicrobenchResult> run_microbenchmarks(const MicrobenchOptions& options, const std::string& filter) {
+    std::vector<MicrobenchResult> results;
+
+    for (const auto& entry : registry()) {
+        if (entry.first.find(filter) == std::string::npos) {
+            continue;
+        }
+        for (const MicrobenchResult& result : entry.second(options)) {
+            results.push_back(result);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,113 @@
+#ifndef MICROBENCH_HPP
+#define MICROBENCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+    Microbenchmarks time small pieces of the simulator (such as a scheduler's ready
+    queue operations) in isolation. They live in *_bench.cpp files anywhere under src,
+    which the makefile builds into cpu-sim-microbench, and register themselves with
+    REGISTER_MICROBENCHMARK, so adding a file is all it takes to add a benchmark.
+*/
+
+/*
+    MicrobenchOptions:
+        The parameters every microbenchmark is run with.
+*/
+
+class MicrobenchOptions {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        depths:
+            The queue depths (items held before and during the timed operations) to
+            benchmark at. The depth a measurement actually saw is in its result.
+    */
+    std::vector<size_t> depths = {16, 1024, 65536};
+
+    /*
+        ops:
+            The number of timed operations per measurement.
+    */
+    size_t ops = 1000000;
+
+    /*
+        time_slice:
+            The time slice given to preemptive schedulers.
+    */
+    int time_slice = 5;
+
+    /*
+        seed:
+            The random seed for the operation mix and the items.
+    */
+    uint64_t seed = 1;
+};
+
+/*
+    MicrobenchResult:
+        One measurement of a microbenchmark.
+*/
+
+class MicrobenchResult {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        name:
+            What was measured, e.g. "RR/pick_add".
+    */
+    std::string name;
+
+    /*
+        depth, ops:
+            The queue depth and number of operations of the measurement.
+    */
+    size_t depth = 0;
+    size_t ops = 0;
+
+    /*
+        mean_depth, max_depth:
+            The mean and largest number of items held as the timed operations ran.
+    */
+    double mean_depth = 0.0;
+    size_t max_depth = 0;
+
+    /*
+        ns_per_op, allocations_per_op:
+            The average time and number of heap allocations per operation.
+    */
+    double ns_per_op = 0.0;
+    double allocations_per_op = 0.0;
+};
+
+using Microbenchmark = std::function<std::vector<MicrobenchResult>(const MicrobenchOptions&)>;
+
+/*
+    register_microbenchmark(name, benchmark):
+        Adds a benchmark to the registry. Returns true, so it can initialize a static.
+*/
+bool register_microbenchmark(const std::string& name, Microbenchmark benchmark);
+
+/*
+    run_microbenchmarks(options, filter):
+        Runs every registered benchmark whose name contains filter and returns all
+        their measurements.
+*/
+std::vector<MicrobenchResult> run_microbenchmarks(const MicrobenchOptions& options, const std::string& filter);
+
+#define REGISTER_MICROBENCHMARK(name, function) \
+    static bool registered_##function = register_microbenchmark(name, function)
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+    The --profile instrumentation of the simulator is only compiled in when
+    CPU_SIM_PROFILE is defined (build with `make PROFILE=1`). Otherwise PROFILE(...)
+    expands to nothing and the event loop carries no trace of it.
+*/
+
+#ifdef CPU_SIM_PROFILE
+#define PROFILE(...) __VA_ARGS__
+#define PROFILING_ENABLED true
+#else
+#define PROFILE(...)
+#define PROFILING_ENABLED false
+#endif
+
+/*
+    Profiler:
+        Counters describing where the simulator itself spends its time: how many events
+        of each type it handled and how long the handlers took, how large the event
+        queue grew, how often the scheduler was called and how many heap allocations
+        each handler made.
+*/
+
+class Profiler {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        event_counts[8], handler_ticks[8], handler_allocations[8]:
+            Per EventType: the number of events handled, the time spent in their
+            handler (in ticks, see now()) and the heap allocations made by it.
+    */
+    uint64_t event_counts[8] = {};
+    uint64_t handler_ticks[8] = {};
+    uint64_t handler_allocations[8] = {};
+
+    /*
+        queue_high_water:
+            The largest number of events waiting in the event queue.
+    */
+    size_t queue_high_water = 0;
+
+    /*
+        scheduler_adds, scheduler_picks:
+            The number of calls to add_to_ready_queue and get_next_thread.
+    */
+    uint64_t scheduler_adds = 0;
+    uint64_t scheduler_picks = 0;
+
+    /*
+        scheduler_pick_ticks:
+            The time spent in get_next_thread, in ticks.
+    */
+    uint64_t scheduler_pick_ticks = 0;
+
+    /*
+        total_ticks, total_ns:
+            The duration of the whole event loop, in ticks and in nanoseconds, which
+            gives the length of a tick.
+    */
+    uint64_t total_ticks = 0;
+    uint64_t total_ns = 0;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        now():
+            A cheap timestamp: the CPU's time stamp counter where there is one, the
+            steady clock in nanoseconds otherwise.
+    */
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /*
+        record_queue_size(size):
+            Updates the event queue high-water mark.
+    */
+    void record_queue_size(size_t size) {
+        if (size > this->queue_high_water) {
+            this->queue_high_water = size;
+        }
+    }
+
+    /*
+        ticks_to_ns(ticks):
+            Converts a number of ticks to nanoseconds.
+    */
+    double ticks_to_ns(uint64_t ticks) const {
+        return this->total_ticks == 0 ? 0.0 : (double) ticks * this->total_ns / this->total_ticks;
+    }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+    RingBuffer:
+        A FIFO queue stored in a single power-of-two sized array. Elements are pushed
+        at the tail and popped from the head, and the indices simply wrap around the
+        array, so steady-state pushes and pops never touch the allocator.
+
+        When the buffer is full the storage is doubled. It is never shrunk, so a
+        queue that has grown to hold N elements keeps that capacity for the rest
+        of the run (call clear() to empty it without giving the memory back).
+
+        The interface mirrors std::queue (push, front, pop, size, empty) so the
+        schedulers can use it as a drop-in replacement.
+*/
+
+template <typename T>
+class RingBuffer {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        RingBuffer(capacity):
+            Creates an empty buffer with room for at least `capacity` elements.
+    */
+    explicit RingBuffer(size_t capacity = 16) {
+        reserve(capacity);
+    }
+
+    /*
+        push(value):
+            Adds an element to the back of the queue, growing the storage if it is full.
+    */
+    void push(T value) {
+        if (count == buffer.size()) {
+            reserve(buffer.size() * 2);
+        }
+        buffer[(head + count) & mask] = std::move(value);
+        count++;
+    }
+
+    /*
+        front():
+            Returns the element at the front of the queue. The queue must not be empty.
+    */
+    T& front() { return buffer[head]; }
+
+    const T& front() const { return buffer[head]; }
+
+    /*
+        pop():
+            Removes the element at the front of the queue and returns it. The queue
+            must not be empty.
+    */
+    T pop() {
+        T value = std::move(buffer[head]);
+        buffer[head] = T();
+        head = (head + 1) & mask;
+        count--;
+        return value;
+    }
+
+    /*
+        operator[](i):
+            Returns the i-th element counting from the front of the queue.
+    */
+    T& operator[](size_t i) { return buffer[(head + i) & mask]; }
+
+    const T& operator[](size_t i) const { return buffer[(head + i) & mask]; }
+
+    /*
+        size():
+            Returns the number of elements in the queue.
+    */
+    size_t size() const { return count; }
+
+    /*
+        empty():
+            Returns true if the queue holds no elements.
+    */
+    bool empty() const { return count == 0; }
+
+    /*
+        capacity():
+            Returns how many elements the queue can hold before it has to grow.
+    */
+    size_t capacity() const { return buffer.size(); }
+
+    /*
+        clear():
+            Removes every element but keeps the storage for reuse.
+    */
+    void clear() {
+        while (count != 0) {
+            pop();
+        }
+        head = 0;
+    }
+
+    /*
+        reserve(capacity):
+            Grows the storage to at least `capacity` elements (rounded up to a power
+            of two), keeping the queued elements in order. Never shrinks.
+    */
+    void reserve(size_t capacity) {
+        size_t new_size = buffer.empty() ? 1 : buffer.size();
+        while (new_size < capacity) {
+            new_size *= 2;
+        }
+        if (new_size == buffer.size()) {
+            return;
+        }
+
+        std::vector<T> grown(new_size);
+        for (size_t i = 0; i < count; i++) {
+            grown[i] = std::move(buffer[(head + i) & mask]);
+        }
+        buffer.swap(grown);
+        head = 0;
+        mask = new_size - 1;
+    }
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        buffer:
+            The backing storage. Its size is always a power of two.
+    */
+    std::vector<T> buffer;
+
+    /*
+        head:
+            The index of the front element within buffer.
+    */
+    size_t head = 0;
+
+    /*
+        count:
+            The number of elements currently in the queue.
+    */
+    size_t count = 0;
+
+    /*
+        mask:
+            buffer.size() - 1, used to wrap indices around the array.
+    */
+    size_t mask = 0;
+};
+
+#endif
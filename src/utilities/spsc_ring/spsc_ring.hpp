@@ -0,0 +1,121 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+/*
+    SpscRing:
+        A fixed-capacity, lock-free queue between exactly one producer thread and one
+        consumer thread. Used to hand records from the simulation thread to a background
+        thread that writes them out, without the simulation ever taking a lock.
+
+        The producer only writes tail and the consumer only writes head; each side keeps
+        a cached copy of the other's index so the shared cache lines are only touched
+        when the ring looks full (or empty). T must be trivially copyable.
+*/
+
+template<typename T>
+class SpscRing {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        SpscRing(capacity):
+            Creates a ring holding up to capacity elements, rounded up to a power of two.
+    */
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        this->slots = std::make_unique<T[]>(size);
+        this->mask = size - 1;
+    }
+
+    /*
+        try_push(value):
+            Producer only. Adds value to the ring, or returns false if it is full.
+    */
+    bool try_push(const T& value) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail - this->cached_head > this->mask) {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            if (tail - this->cached_head > this->mask) {
+                return false;
+            }
+        }
+
+        this->slots[tail & this->mask] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+        push(value):
+            Producer only. Adds value to the ring, waiting for the consumer to make room
+            if it is full. This is the ring's backpressure: a producer that outruns the
+            consumer is slowed down to its pace rather than dropping anything.
+    */
+    void push(const T& value) {
+        while (!try_push(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /*
+        pop_batch(out, max):
+            Consumer only. Moves up to max elements into out, oldest first, and returns
+            how many were moved (0 if the ring is empty).
+    */
+    size_t pop_batch(T* out, size_t max) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (this->cached_tail == head) {
+            this->cached_tail = this->tail.load(std::memory_order_acquire);
+        }
+
+        size_t count = this->cached_tail - head;
+        if (count > max) {
+            count = max;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = this->slots[(head + i) & this->mask];
+        }
+
+        this->head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /*
+        capacity():
+            The maximum number of elements the ring can hold.
+    */
+    size_t capacity() const { return this->mask + 1; }
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::unique_ptr<T[]> slots;
+    size_t mask = 0;
+
+    // Written by the consumer.
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+
+    // Written by the producer.
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+};
+
+#endif
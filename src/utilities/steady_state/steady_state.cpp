@@ -0,0 +1,274 @@
+#include "utilities/steady_state/steady_state.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// The 97.5% quantiles of Student's t distribution with 1 to 30 degrees of freedom.
+static const double T_QUANTILES[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t_quantile(size_t degrees_of_freedom) {
+    if (degrees_of_freedom == 0) {
+        return 0.0;
+    }
+    return degrees_of_freedom <= 30 ? T_QUANTILES[degrees_of_freedom - 1] : 1.96;
+}
+
+static ConfidenceInterval confidence_interval(const std::vector<double>& batch_values) {
+    ConfidenceInterval interval;
+    size_t n = batch_values.size();
+    if (n == 0) {
+        return interval;
+    }
+
+    double sum = 0.0;
+    for (double value : batch_values) {
+        sum += value;
+    }
+    interval.mean = sum / n;
+
+    if (n > 1) {
+        double squares = 0.0;
+        for (double value : batch_values) {
+            squares += (value - interval.mean) * (value - interval.mean);
+        }
+        interval.half_width = t_quantile(n - 1) * std::sqrt(squares / (n - 1) / n);
+    }
+    return interval;
+}
+
+bool ConvergenceMonitor::add(double value) {
+    this->batch_sum += value;
+    if (++this->batch_count < this->batch_size) {
+        return false;
+    }
+
+    double batch_mean = this->batch_sum / this->batch_count;
+    this->batch_sum = 0.0;
+    this->batch_count = 0;
+
+    this->num_batches++;
+    double delta = batch_mean - this->mean;
+    this->mean += delta / this->num_batches;
+    this->squares += delta * (batch_mean - this->mean);
+
+    if (this->num_batches < std::max<size_t>(2, this->min_batches)) {
+        return false;
+    }
+    ConfidenceInterval current = this->interval();
+    return current.half_width <= this->precision * std::fabs(current.mean);
+}
+
+ConfidenceInterval ConvergenceMonitor::interval() const {
+    ConfidenceInterval interval;
+    interval.mean = this->mean;
+    if (this->num_batches > 1) {
+        interval.half_width = t_quantile(this->num_batches - 1)
+            * std::sqrt(this->squares / (this->num_batches - 1) / this->num_batches);
+    }
+    return interval;
+}
+
+// Whether the values grow with their index by more than chance explains: the slope
+// of their least-squares line is positive and significant at the 97.5% level.
+static bool trends_upward(const std::vector<double>& values) {
+    size_t n = values.size();
+    if (n < 3) {
+        return false;
+    }
+
+    double mean_x = (n - 1) / 2.0, mean_y = 0.0;
+    for (double value : values) {
+        mean_y += value;
+    }
+    mean_y /= n;
+
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sxx += (i - mean_x) * (i - mean_x);
+        sxy += (i - mean_x) * (values[i] - mean_y);
+    }
+    double slope = sxy / sxx;
+    if (slope <= 0) {
+        return false;
+    }
+
+    double residuals = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double residual = values[i] - mean_y - slope * (i - mean_x);
+        residuals += residual * residual;
+    }
+    double standard_error = std::sqrt(residuals / (n - 2) / sxx);
+    return slope > t_quantile(n - 2) * standard_error;
+}
+
+size_t mser_truncation(const std::vector<double>& means) {
+    size_t n = means.size();
+    if (n < 2) {
+        return 0;
+    }
+
+    // Suffix sums make every candidate O(1).
+    std::vector<double> sums(n + 1, 0.0), squares(n + 1, 0.0);
+    for (size_t i = n; i-- > 0;) {
+        sums[i] = sums[i + 1] + means[i];
+        squares[i] = squares[i + 1] + means[i] * means[i];
+    }
+
+    size_t best = 0;
+    double best_statistic = INFINITY;
+    for (size_t d = 0; d <= n / 2; ++d) {
+        double remaining = (double) (n - d);
+        double mean = sums[d] / remaining;
+        double variance = std::max(0.0, squares[d] / remaining - mean * mean);
+        double statistic = variance / remaining;
+        if (statistic < best_statistic) {
+            best_statistic = statistic;
+            best = d;
+        }
+    }
+    return best;
+}
+
+SteadyStateRecorder::SteadyStateRecorder(size_t num_batches):
+    num_batches(std::max<size_t>(1, num_batches)), max_batches(4 * this->num_batches) {}
+
+void SteadyStateRecorder::record(SimTime end_time, SimTime response_time, SimTime turnaround_time, SimTime busy_time) {
+    if (this->batches.empty() || this->batches.back().count == this->batch_size) {
+        if (this->batches.size() == this->max_batches) {
+            merge_pairs();
+        }
+        this->batches.emplace_back();
+    }
+
+    SteadyStateBatch& batch = this->batches.back();
+    batch.count++;
+    batch.response_sum += response_time;
+    batch.turnaround_sum += turnaround_time;
+    batch.turnaround_times.record(turnaround_time);
+    batch.end_time = end_time;
+    batch.busy_time = busy_time;
+}
+
+void SteadyStateRecorder::merge_pairs() {
+    size_t merged = this->batches.size() / 2;
+    for (size_t i = 0; i < merged; ++i) {
+        // Pair i lands in slot i, which pair i / 2 has already been read from.
+        SteadyStateBatch& merged = this->batches[i];
+        if (i != 0) {
+            merged = this->batches[2 * i];
+        }
+        const SteadyStateBatch& second = this->batches[2 * i + 1];
+        merged.count += second.count;
+        merged.response_sum += second.response_sum;
+        merged.turnaround_sum += second.turnaround_sum;
+        merged.turnaround_times.merge(second.turnaround_times);
+        merged.end_time = second.end_time;
+        merged.busy_time = second.busy_time;
+    }
+    this->batches.resize(merged);
+    this->batch_size *= 2;
+}
+
+SteadyStateReport SteadyStateRecorder::analyze(SimTime warmup_time, double offered_load) const {
+    SteadyStateReport report;
+    const std::vector<SteadyStateBatch>& batches = this->batches;
+    for (const SteadyStateBatch& batch : batches) {
+        report.num_samples += batch.count;
+    }
+    if (batches.empty()) {
+        return report;
+    }
+    report.end_time = batches.back().end_time;
+
+    size_t warmup_batches = 0;
+    if (warmup_time < 0) {
+        std::vector<double> means(batches.size());
+        for (size_t i = 0; i < batches.size(); ++i) {
+            means[i] = batches[i].turnaround_sum / batches[i].count;
+        }
+        warmup_batches = mser_truncation(means);
+        report.warmup_detected = true;
+    } else {
+        while (warmup_batches < batches.size() && batches[warmup_batches].end_time < warmup_time) {
+            warmup_batches++;
+        }
+    }
+    for (size_t i = 0; i < warmup_batches; ++i) {
+        report.warmup_samples += batches[i].count;
+    }
+    report.warmup_time = warmup_batches == 0 ? 0 : batches[warmup_batches - 1].end_time;
+
+    // The measured micro-batches are shared out as evenly as they go, so none is left over.
+    size_t measured = batches.size() - warmup_batches;
+    report.num_batches = std::min(this->num_batches, measured);
+    if (report.num_batches == 0) {
+        return report;
+    }
+    report.batch_size = (report.num_samples - report.warmup_samples) / report.num_batches;
+
+    std::vector<double> response, turnaround, p99, throughput, utilization;
+    SimTime batch_start = report.warmup_time;
+    SimTime busy_start = warmup_batches == 0 ? 0 : batches[warmup_batches - 1].busy_time;
+
+    for (size_t b = 0; b < report.num_batches; ++b) {
+        size_t first = warmup_batches + b * measured / report.num_batches;
+        size_t end = warmup_batches + (b + 1) * measured / report.num_batches;
+        size_t count = 0;
+        double response_sum = 0.0, turnaround_sum = 0.0;
+        LatencyHistogram turnaround_times;
+
+        for (size_t i = first; i < end; ++i) {
+            count += batches[i].count;
+            response_sum += batches[i].response_sum;
+            turnaround_sum += batches[i].turnaround_sum;
+            turnaround_times.merge(batches[i].turnaround_times);
+        }
+
+        const SteadyStateBatch& last = batches[end - 1];
+        double length = std::max<SimTime>(1, last.end_time - batch_start);
+        double busy = last.busy_time - busy_start;
+        batch_start = last.end_time;
+        busy_start = last.busy_time;
+
+        response.push_back(response_sum / count);
+        turnaround.push_back(turnaround_sum / count);
+        p99.push_back(turnaround_times.percentile(99));
+        throughput.push_back(count * 1000.0 / length);
+        utilization.push_back(busy * 100.0 / length);
+    }
+
+    if (offered_load >= 100.0) {
+        report.stable = false;
+        report.instability = "the offered load is at least 100%";
+        return report;
+    }
+    if (trends_upward(turnaround)) {
+        report.stable = false;
+        report.instability = "the turnaround time keeps growing from batch to batch";
+        return report;
+    }
+
+    report.response_time = confidence_interval(response);
+    report.turnaround_time = confidence_interval(turnaround);
+    report.p99_turnaround_time = confidence_interval(p99);
+    report.throughput = confidence_interval(throughput);
+    report.utilization = confidence_interval(utilization);
+    return report;
+}
+
+void SteadyStateRecorder::save(CheckpointWriter& writer) const {
+    writer.write<uint64_t>(this->batch_size);
+    writer.write_vector(this->batches);
+}
+
+void SteadyStateRecorder::restore(CheckpointReader& reader) {
+    this->batch_size = reader.read<uint64_t>();
+    reader.read_vector(this->batches);
+    if (this->batch_size == 0 || this->batches.size() > this->max_batches) {
+        reader.fail("bad steady-state batches");
+    }
+}
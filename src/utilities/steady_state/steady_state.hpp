@@ -0,0 +1,269 @@
+#ifndef STEADY_STATE_HPP
+#define STEADY_STATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types/histogram/histogram.hpp"
+#include "types/sim_time/sim_time.hpp"
+#include "utilities/checkpoint/checkpoint.hpp"
+
+/*
+    SteadyStateBatch:
+        What an open-system run records about a run of consecutively exiting threads
+        (a micro-batch): enough to compute every steady-state metric of any range of
+        micro-batches, without keeping anything per thread.
+*/
+
+class SteadyStateBatch {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    size_t count = 0;
+    double response_sum = 0.0;
+    double turnaround_sum = 0.0;
+    LatencyHistogram turnaround_times;
+
+    /*
+        end_time, busy_time:
+            When the last thread of the batch exited, and how long the CPU had been
+            busy (running threads or dispatching) since the start of the run by then.
+    */
+    SimTime end_time = 0;
+    SimTime busy_time = 0;
+};
+
+/*
+    ConfidenceInterval:
+        An estimate with the half-width of its 95% confidence interval, i.e. the true
+        value is in [mean - half_width, mean + half_width] with 95% confidence.
+*/
+
+class ConfidenceInterval {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    double mean = 0.0;
+    double half_width = 0.0;
+};
+
+/*
+    SteadyStateReport:
+        The steady-state metrics of an open-system run, estimated by batch means: the
+        samples left after the warm-up are split into equal batches in exit order, each
+        metric is computed per batch, and the batch values are treated as independent
+        observations (which they nearly are once batches are long enough).
+*/
+
+class SteadyStateReport {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        num_samples, warmup_samples:
+            How many threads exited during the run, and how many of the first ones
+            were discarded as the warm-up.
+    */
+    size_t num_samples = 0;
+    size_t warmup_samples = 0;
+
+    /*
+        warmup_time, end_time:
+            The measured window: from the exit of the last warm-up thread to the exit
+            of the last thread.
+    */
+    SimTime warmup_time = 0;
+    SimTime end_time = 0;
+
+    /*
+        warmup_detected:
+            Whether the warm-up was found by MSER rather than given.
+    */
+    bool warmup_detected = false;
+
+    /*
+        stable, instability:
+            Whether the run reached a steady state, and if not why: the offered load
+            is at least 100%, or the batch means of the turnaround time keep growing.
+            Without a steady state the metrics below are not meaningful, and the
+            confidence intervals are left out.
+    */
+    bool stable = true;
+    std::string instability;
+
+    /*
+        num_batches, batch_size:
+            How the measured threads were batched (0 batches if there were too few).
+            Batches differ in size by at most a micro-batch, and batch_size is their
+            average.
+    */
+    size_t num_batches = 0;
+    size_t batch_size = 0;
+
+    /*
+        response_time, turnaround_time, p99_turnaround_time:
+            Per-thread latencies over the measured window.
+    */
+    ConfidenceInterval response_time;
+    ConfidenceInterval turnaround_time;
+    ConfidenceInterval p99_turnaround_time;
+
+    /*
+        throughput:
+            Threads exiting per 1000 ticks.
+    */
+    ConfidenceInterval throughput;
+
+    /*
+        utilization:
+            The time the CPU was busy (running threads or dispatching) during a batch
+            over the batch's length, in percent, as in the run's own CPU utilization.
+    */
+    ConfidenceInterval utilization;
+};
+
+/*
+    ConvergenceMonitor:
+        Watches a running metric for a run that should stop as soon as the metric is
+        known precisely enough. Values are averaged in batches, and the metric has
+        converged once the 95% confidence interval of the mean of the batch means is
+        within the given relative precision (after a minimum number of batches, so an
+        early lucky streak does not end the run).
+*/
+
+class ConvergenceMonitor {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        ConvergenceMonitor(precision, batch_size, min_batches):
+            Converges when the half-width of the interval is at most precision times
+            the mean (e.g. 0.05 for +/-5%).
+    */
+    ConvergenceMonitor(double precision, size_t batch_size = 100, size_t min_batches = 10):
+        precision(precision), batch_size(batch_size), min_batches(min_batches) {}
+
+    /*
+        add(value):
+            Records a value. Returns true if the metric has converged.
+    */
+    bool add(double value);
+
+    /*
+        interval():
+            The current estimate of the mean, from the complete batches so far.
+    */
+    ConfidenceInterval interval() const;
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    double precision;
+    size_t batch_size;
+    size_t min_batches;
+    double batch_sum = 0.0;
+    size_t batch_count = 0;
+    size_t num_batches = 0;
+    // Welford's running mean and sum of squared deviations of the batch means.
+    double mean = 0.0;
+    double squares = 0.0;
+};
+
+/*
+    SteadyStateRecorder:
+        Records the threads exiting an open-system run in micro-batches, in constant
+        memory however long the run: micro-batches start at 5 threads, and whenever
+        there are 4 per requested batch they are merged in pairs and their size
+        doubles. There are always between 2 and 4 micro-batches per batch, enough to
+        drop up to half of them as the warm-up and still fill every batch.
+*/
+
+class SteadyStateRecorder {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        SteadyStateRecorder(num_batches):
+            Records for a report with num_batches batches.
+    */
+    explicit SteadyStateRecorder(size_t num_batches = 20);
+
+    /*
+        record(end_time, response_time, turnaround_time, busy_time):
+            Records a thread exiting at end_time, with the CPU's busy time since the
+            start of the run at that point.
+    */
+    void record(SimTime end_time, SimTime response_time, SimTime turnaround_time, SimTime busy_time);
+
+    /*
+        analyze(warmup_time, offered_load):
+            Computes the steady-state report of the threads recorded so far. The
+            warm-up is every micro-batch whose last thread exited before warmup_time,
+            or is detected with MSER on the micro-batch turnaround means if
+            warmup_time is negative. offered_load (in percent) is the CPU demand of
+            the arrivals; at 100% or more there is no steady state.
+    */
+    SteadyStateReport analyze(SimTime warmup_time, double offered_load) const;
+
+    /*
+        save(writer), restore(reader):
+            Save the micro-batches in a checkpoint, and continue from them in a
+            recorder made for the same number of batches.
+    */
+    void save(CheckpointWriter& writer) const;
+
+    void restore(CheckpointReader& reader);
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    size_t num_batches;
+    // The threads per micro-batch, and the most micro-batches kept before merging.
+    size_t batch_size = 5;
+    size_t max_batches;
+    std::vector<SteadyStateBatch> batches;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        merge_pairs():
+            Halves the number of micro-batches by merging them in pairs.
+    */
+    void merge_pairs();
+};
+
+/*
+    mser_truncation(means):
+        The number of leading batch means to discard as warm-up, by the MSER rule:
+        the truncation point d (searched over the first half) minimising the variance
+        of the remaining means divided by their count squared wins. With batches of
+        5 values this is MSER-5.
+*/
+size_t mser_truncation(const std::vector<double>& means);
+
+#endif
@@ -0,0 +1,20 @@
+#include "utilities/temp_file/temp_file.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+std::string temporary_file(const std::string& prefix) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string name = (directory / (prefix + "-XXXXXX")).string();
+
+    int fd = mkstemp(&name[0]);
+    if (fd == -1) {
+        std::cerr << "Unable to create a temporary file in " << directory << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+    close(fd);
+    return name;
+}
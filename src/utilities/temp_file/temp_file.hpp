@@ -0,0 +1,14 @@
+#ifndef TEMP_FILE_HPP
+#define TEMP_FILE_HPP
+
+#include <string>
+
+/*
+    temporary_file(prefix):
+        Creates a new, empty file with a unique name starting with prefix in the
+        system's temporary directory, and returns its path. The caller removes it when
+        done. Throws std::logic_error if no file can be created.
+*/
+std::string temporary_file(const std::string& prefix);
+
+#endif
@@ -0,0 +1,135 @@
+#include "utilities/thread_export/thread_export.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "utilities/fmt/format.h"
+
+// How much CSV text to collect before writing it out.
+static const size_t CSV_BUFFER_SIZE = 1 << 16;
+
+static void open_file(std::ofstream& file, const std::string& filename, std::ios::openmode mode) {
+    file.open(filename.c_str(), mode);
+
+    if (!file) {
+        std::cerr << "Unable to open export file: " << filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+}
+
+std::unique_ptr<ThreadExporter> ThreadExporter::open(const std::string& filename) {
+    const std::string csv = ".csv";
+
+    if (filename.size() >= csv.size() && filename.compare(filename.size() - csv.size(), csv.size(), csv) == 0) {
+        return std::make_unique<CsvThreadExporter>(filename);
+    }
+    return std::make_unique<ColumnarThreadExporter>(filename);
+}
+
+//==============================================================================
+// CSV
+//==============================================================================
+
+CsvThreadExporter::CsvThreadExporter(const std::string& filename) {
+    open_file(this->file, filename, std::ios::out | std::ios::trunc);
+
+    this->buffer.reserve(CSV_BUFFER_SIZE + 256);
+    this->buffer = "process,thread,priority,arrival,start,end,service,io\n";
+}
+
+CsvThreadExporter::~CsvThreadExporter() {
+    this->close();
+}
+
+void CsvThreadExporter::write(const Thread* thread) {
+    fmt::format_to(std::back_inserter(this->buffer), "{},{},{},{},{},{},{},{}\n",
+        thread->process_id, thread->thread_id, (int) thread->priority, thread->arrival_time,
+        thread->start_time, thread->end_time, thread->service_time, thread->io_time);
+
+    if (this->buffer.size() >= CSV_BUFFER_SIZE) {
+        this->flush();
+    }
+}
+
+void CsvThreadExporter::flush() {
+    this->file.write(this->buffer.data(), this->buffer.size());
+    this->buffer.clear();
+}
+
+void CsvThreadExporter::close() {
+    if (this->file.is_open()) {
+        this->flush();
+        this->file.close();
+    }
+}
+
+//==============================================================================
+// Columnar binary
+//==============================================================================
+
+ColumnarThreadExporter::ColumnarThreadExporter(const std::string& filename) {
+    open_file(this->file, filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    this->file.write("CPUSIMT1", 8);
+
+    this->process_ids.reserve(BLOCK_ROWS);
+    this->thread_ids.reserve(BLOCK_ROWS);
+    this->priorities.reserve(BLOCK_ROWS);
+    this->arrival_times.reserve(BLOCK_ROWS);
+    this->start_times.reserve(BLOCK_ROWS);
+    this->end_times.reserve(BLOCK_ROWS);
+    this->service_times.reserve(BLOCK_ROWS);
+    this->io_times.reserve(BLOCK_ROWS);
+}
+
+ColumnarThreadExporter::~ColumnarThreadExporter() {
+    this->close();
+}
+
+void ColumnarThreadExporter::write(const Thread* thread) {
+    this->process_ids.push_back(thread->process_id);
+    this->thread_ids.push_back(thread->thread_id);
+    this->priorities.push_back((uint8_t) thread->priority);
+    this->arrival_times.push_back(thread->arrival_time);
+    this->start_times.push_back(thread->start_time);
+    this->end_times.push_back(thread->end_time);
+    this->service_times.push_back(thread->service_time);
+    this->io_times.push_back(thread->io_time);
+
+    if (this->process_ids.size() == BLOCK_ROWS) {
+        this->flush();
+    }
+}
+
+void ColumnarThreadExporter::flush() {
+    if (this->process_ids.empty()) {
+        return;
+    }
+
+    uint32_t rows = (uint32_t) this->process_ids.size();
+    this->file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+
+    write_column(this->process_ids);
+    write_column(this->thread_ids);
+    write_column(this->priorities);
+    write_column(this->arrival_times);
+    write_column(this->start_times);
+    write_column(this->end_times);
+    write_column(this->service_times);
+    write_column(this->io_times);
+
+    this->process_ids.clear();
+    this->thread_ids.clear();
+    this->priorities.clear();
+    this->arrival_times.clear();
+    this->start_times.clear();
+    this->end_times.clear();
+    this->service_times.clear();
+    this->io_times.clear();
+}
+
+void ColumnarThreadExporter::close() {
+    if (this->file.is_open()) {
+        this->flush();
+        this->file.close();
+    }
+}
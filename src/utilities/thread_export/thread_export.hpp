@@ -0,0 +1,173 @@
+#ifndef THREAD_EXPORT_HPP
+#define THREAD_EXPORT_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types/thread/thread.hpp"
+
+/*
+    ThreadExporter:
+        Writes the metrics of every thread to a file as the thread exits, for loading
+        into analysis tools. Rows are written in exit order, one per thread, with the
+        fields: process, thread, priority, arrival, start, end, service, io.
+
+        Output is buffered and only written to the file in large chunks, so exporting
+        tens of millions of threads costs little more than simulating them.
+*/
+
+class ThreadExporter {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        open(filename):
+            Creates an exporter writing to filename. The format is picked from the
+            name: CSV if it ends in ".csv", the columnar binary format otherwise.
+            Throws std::logic_error if the file cannot be opened.
+    */
+    static std::unique_ptr<ThreadExporter> open(const std::string& filename);
+
+    /*
+        write(thread):
+            Adds a row for a thread that has exited.
+    */
+    virtual void write(const Thread* thread) = 0;
+
+    /*
+        close():
+            Writes out anything still buffered and closes the file. Called by the
+            destructor if it was not called before.
+    */
+    virtual void close() = 0;
+
+    virtual ~ThreadExporter() {}
+};
+
+/*
+    CsvThreadExporter:
+        Writes one CSV line per thread, after a header line with the field names.
+*/
+
+class CsvThreadExporter : public ThreadExporter {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    CsvThreadExporter(const std::string& filename);
+
+    ~CsvThreadExporter();
+
+    void write(const Thread* thread) override;
+
+    void close() override;
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::ofstream file;
+
+    /*
+        buffer:
+            The formatted lines not written to the file yet.
+    */
+    std::string buffer;
+
+    /*
+        flush():
+            Writes the buffer to the file and empties it.
+    */
+    void flush();
+};
+
+/*
+    ColumnarThreadExporter:
+        Writes the rows in a simple columnar binary format, which can be loaded by
+        reading whole arrays instead of parsing text.
+
+        The file starts with the 8 byte magic "CPUSIMT1", followed by any number of
+        blocks. Each block holds up to BLOCK_ROWS rows and is laid out as:
+
+            uint32  row count n
+            int32   process[n]
+            int32   thread[n]
+            uint8   priority[n]
+            int64   arrival[n]
+            int64   start[n]
+            int64   end[n]
+            int64   service[n]
+            int64   io[n]
+
+        All values are in the byte order of the machine that wrote the file (little
+        endian on x86 and ARM).
+*/
+
+class ColumnarThreadExporter : public ThreadExporter {
+public:
+
+    //==================================================
+    //  Constants
+    //==================================================
+
+    static const size_t BLOCK_ROWS = 1 << 16;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    ColumnarThreadExporter(const std::string& filename);
+
+    ~ColumnarThreadExporter();
+
+    void write(const Thread* thread) override;
+
+    void close() override;
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    std::ofstream file;
+
+    /*
+        The columns of the block being filled.
+    */
+    std::vector<int32_t> process_ids;
+    std::vector<int32_t> thread_ids;
+    std::vector<uint8_t> priorities;
+    std::vector<int64_t> arrival_times;
+    std::vector<int64_t> start_times;
+    std::vector<int64_t> end_times;
+    std::vector<int64_t> service_times;
+    std::vector<int64_t> io_times;
+
+    /*
+        flush():
+            Writes the rows collected so far as one block and starts a new one.
+    */
+    void flush();
+
+    /*
+        write_column(column):
+            Writes the raw contents of a column to the file.
+    */
+    template<typename T>
+    void write_column(const std::vector<T>& column) {
+        file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+    }
+};
+
+#endif
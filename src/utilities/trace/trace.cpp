@@ -0,0 +1,190 @@
+#include "utilities/trace/trace.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+static const char TRACE_MAGIC[8] = {'C', 'P', 'U', 'S', 'I', 'M', 'T', 'R'};
+
+//==============================================================================
+// TraceRecorder
+//==============================================================================
+
+void TraceRecorder::start() {
+    this->worker = std::thread(&TraceRecorder::drain, this);
+}
+
+void TraceRecorder::close() {
+    if (!this->worker.joinable()) {
+        return;
+    }
+
+    this->done.store(true, std::memory_order_release);
+    this->worker.join();
+}
+
+void TraceRecorder::drain() {
+    std::vector<TraceRecord> batch(WRITE_BATCH);
+
+    while (true) {
+        // Read done before draining, so nothing pushed before close() can be missed.
+        bool finishing = this->done.load(std::memory_order_acquire);
+        size_t count = this->ring.pop_batch(batch.data(), batch.size());
+
+        if (count != 0) {
+            this->write_batch(batch.data(), count);
+        } else if (finishing) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+//==============================================================================
+// TraceWriter
+//==============================================================================
+
+TraceWriter::TraceWriter(const std::string& filename, const Workload& workload) {
+    this->file.open(filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if (!this->file) {
+        std::cerr << "Unable to open trace file: " << filename << std::endl;
+        throw(std::logic_error("Bad file."));
+    }
+
+    this->file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+
+    uint32_t num_threads = (uint32_t) workload.threads.size();
+    this->file.write(reinterpret_cast<const char*>(&num_threads), sizeof(num_threads));
+
+    for (const ThreadSpec& spec : workload.threads) {
+        int32_t entry[3] = {spec.process_id, spec.thread_id, (int32_t) spec.priority};
+        this->file.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+    }
+
+    this->start();
+}
+
+TraceWriter::~TraceWriter() {
+    this->close();
+}
+
+void TraceWriter::close() {
+    TraceRecorder::close();
+
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+}
+
+void TraceWriter::write_batch(const TraceRecord* records, size_t count) {
+    this->file.write(reinterpret_cast<const char*>(records), count * sizeof(TraceRecord));
+}
+
+//==============================================================================
+// TraceDecoder
+//==============================================================================
+
+void TraceDecoder::decode(const TraceRecord* records, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const TraceRecord& record = records[i];
+        this->time += record.time_delta;
+
+        if (record.kind == TraceRecord::CLOCK) {
+            this->time = record.wide(0);
+            continue;
+        }
+
+        if (record.thread >= this->threads.size()) {
+            std::cerr << "Trace record for an unknown thread." << std::endl;
+            throw(std::logic_error("Bad trace."));
+        }
+
+        Thread* thread = &this->threads[record.thread];
+        Event event((EventType) record.event_type, this->time, 0, thread);
+
+        switch (record.kind) {
+            case TraceRecord::TRANSITION:
+                this->logger.print_state_transition(event, (ThreadState) record.before, (ThreadState) record.after);
+                break;
+
+            case TraceRecord::DECISION: {
+                SchedulingDecision decision;
+                decision.thread = thread;
+                decision.reason = (DecisionReason) record.before;
+                decision.queue = record.after;
+                decision.time_slice = record.time_slice;
+                for (int q = 0; q < 4; ++q) {
+                    decision.queue_sizes[q] = record.queue_sizes[q];
+                }
+                this->logger.print_verbose(event, thread, decision.explanation());
+                break;
+            }
+
+            case TraceRecord::SUMMARY:
+                thread->arrival_time = record.wide(0);
+                thread->service_time = record.wide(1);
+                thread->end_time = this->time;
+                break;
+
+            case TraceRecord::SUMMARY_IO:
+                thread->io_time = record.wide(0);
+                this->logger.print_thread_summary(thread);
+                break;
+        }
+    }
+}
+
+void decode_trace(std::istream& input, const Logger& logger) {
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t num_threads = 0;
+
+    input.read(magic, sizeof(magic));
+    input.read(reinterpret_cast<char*>(&num_threads), sizeof(num_threads));
+
+    if (!input || std::memcmp(magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        std::cerr << "Not a simulation trace." << std::endl;
+        throw(std::logic_error("Bad trace."));
+    }
+
+    TraceDecoder decoder(logger);
+    for (uint32_t i = 0; i < num_threads; ++i) {
+        int32_t entry[3];
+        input.read(reinterpret_cast<char*>(entry), sizeof(entry));
+        decoder.add_thread(entry[0], entry[1], (ProcessPriority) entry[2]);
+    }
+
+    if (!input) {
+        std::cerr << "Truncated trace header." << std::endl;
+        throw(std::logic_error("Bad trace."));
+    }
+
+    std::vector<TraceRecord> batch(TraceRecorder::WRITE_BATCH);
+
+    while (input) {
+        input.read(reinterpret_cast<char*>(batch.data()), batch.size() * sizeof(TraceRecord));
+        decoder.decode(batch.data(), input.gcount() / sizeof(TraceRecord));
+    }
+}
+
+//==============================================================================
+// AsyncLogger
+//==============================================================================
+
+AsyncLogger::AsyncLogger(const Logger& logger, const Workload& workload) : decoder(logger) {
+    for (const ThreadSpec& spec : workload.threads) {
+        this->decoder.add_thread(spec.process_id, spec.thread_id, spec.priority);
+    }
+
+    this->start();
+}
+
+AsyncLogger::~AsyncLogger() {
+    this->close();
+}
+
+void AsyncLogger::write_batch(const TraceRecord* records, size_t count) {
+    this->decoder.decode(records, count);
+}
@@ -0,0 +1,406 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "types/enums.hpp"
+#include "types/scheduling_decision/scheduling_decision.hpp"
+#include "types/sim_time/sim_time.hpp"
+#include "types/thread/thread.hpp"
+#include "types/workload/workload.hpp"
+#include "utilities/logger/logger.hpp"
+#include "utilities/spsc_ring/spsc_ring.hpp"
+
+/*
+    TraceRecord:
+        One entry of a binary trace: a state transition of a thread or a scheduling
+        decision of the dispatcher (one block of the verbose output), or the summary of
+        an exited thread.
+        Records are fixed-size so a trace can be written and read as raw arrays.
+
+        Times are stored as 32-bit deltas. The rare gap too long for one is bridged by
+        a CLOCK record carrying the full time, and the 64-bit times of a summary take
+        two records (SUMMARY, then SUMMARY_IO), so a trace costs no more for being able
+        to cover any SimTime.
+*/
+
+class TraceRecord {
+public:
+
+    //==================================================
+    //  Constants
+    //==================================================
+
+    static const uint8_t TRANSITION = 0;
+    static const uint8_t DECISION = 1;
+    static const uint8_t SUMMARY = 2;
+    static const uint8_t SUMMARY_IO = 3;
+    static const uint8_t CLOCK = 4;
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        time_delta:
+            The simulation time of the record minus that of the previous record (0
+            for a CLOCK record, which sets the time instead).
+    */
+    uint32_t time_delta = 0;
+
+    /*
+        kind:
+            TRANSITION, DECISION, SUMMARY and SUMMARY_IO (the final metrics of an
+            exited thread), or CLOCK.
+    */
+    uint8_t kind = TRANSITION;
+
+    /*
+        event_type:
+            The type of the event being handled (DISPATCHER_INVOKED for decisions).
+    */
+    uint8_t event_type = 0;
+
+    /*
+        before, after:
+            For a transition, the thread's states before and after. For a decision,
+            the DecisionReason and the queue the thread was taken from.
+    */
+    uint8_t before = 0;
+    uint8_t after = 0;
+
+    /*
+        thread:
+            The thread's handle: its index in the trace's thread table.
+    */
+    uint32_t thread = 0;
+
+    /*
+        time_slice, queue_sizes:
+            For a decision, the matching fields of the SchedulingDecision. Otherwise
+            queue_sizes holds two 64-bit values (see wide): the thread's arrival and
+            service times for a SUMMARY, its I/O time for a SUMMARY_IO, and the time
+            for a CLOCK. A summary's record time is the thread's end time.
+    */
+    int32_t time_slice = -1;
+    uint32_t queue_sizes[4] = {0, 0, 0, 0};
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        set_wide(index, value), wide(index):
+            Store and load the 64-bit value in queue_sizes[2 * index, 2 * index + 1].
+    */
+    void set_wide(int index, int64_t value) { std::memcpy(&this->queue_sizes[2 * index], &value, sizeof(value)); }
+
+    int64_t wide(int index) const {
+        int64_t value;
+        std::memcpy(&value, &this->queue_sizes[2 * index], sizeof(value));
+        return value;
+    }
+};
+
+static_assert(sizeof(TraceRecord) == 32, "trace records are 32 bytes");
+
+/*
+    TraceRecorder:
+        Hands trace records from the simulation thread to a background thread.
+
+        The simulation thread only fills in fixed-size records and pushes them into a
+        lock-free ring; the background thread drains the ring in batches and passes
+        them to write_batch. If the background thread falls behind, the simulation
+        waits for room in the ring, so no record is ever lost.
+
+        Subclasses decide what happens to the records. They must call start() at the
+        end of their constructor and close() in their destructor, so the background
+        thread never runs while they are not fully constructed.
+*/
+
+class TraceRecorder {
+public:
+
+    //==================================================
+    //  Constants
+    //==================================================
+
+    static const size_t RING_SIZE = 1 << 16;
+    static const size_t WRITE_BATCH = 1 << 12;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    virtual ~TraceRecorder() {}
+
+    /*
+        record_transition(time, type, thread, before_state, after_state):
+            Records that thread went from before_state to after_state while handling
+            an event of the given type.
+    */
+    void record_transition(SimTime time, EventType type, const Thread* thread, ThreadState before_state, ThreadState after_state) {
+        TraceRecord record;
+        record.time_delta = this->advance(time);
+        record.kind = TraceRecord::TRANSITION;
+        record.event_type = (uint8_t) type;
+        record.before = (uint8_t) before_state;
+        record.after = (uint8_t) after_state;
+        record.thread = thread->handle;
+
+        this->ring.push(record);
+    }
+
+    /*
+        record_decision(time, decision):
+            Records the dispatcher's choice of decision.thread.
+    */
+    void record_decision(SimTime time, const SchedulingDecision& decision) {
+        TraceRecord record;
+        record.time_delta = this->advance(time);
+        record.kind = TraceRecord::DECISION;
+        record.event_type = (uint8_t) DISPATCHER_INVOKED;
+        record.before = (uint8_t) decision.reason;
+        record.after = (uint8_t) decision.queue;
+        record.thread = decision.thread->handle;
+        record.time_slice = decision.time_slice;
+        for (int i = 0; i < 4; ++i) {
+            record.queue_sizes[i] = decision.queue_sizes[i];
+        }
+
+        this->ring.push(record);
+    }
+
+    /*
+        record_summary(time, thread):
+            Records the final metrics of a thread that has exited.
+    */
+    void record_summary(SimTime time, const Thread* thread) {
+        TraceRecord record;
+        record.time_delta = this->advance(time);
+        record.kind = TraceRecord::SUMMARY;
+        record.event_type = (uint8_t) THREAD_COMPLETED;
+        record.thread = thread->handle;
+        record.set_wide(0, thread->arrival_time);
+        record.set_wide(1, thread->service_time);
+        this->ring.push(record);
+
+        record.time_delta = 0;
+        record.kind = TraceRecord::SUMMARY_IO;
+        record.set_wide(0, thread->io_time);
+        record.set_wide(1, 0);
+        this->ring.push(record);
+    }
+
+    /*
+        close():
+            Waits for the background thread to handle every record and stops it.
+    */
+    void close();
+
+protected:
+
+    /*
+        start():
+            Starts the background thread.
+    */
+    void start();
+
+    /*
+        write_batch(records, count):
+            Called on the background thread with the next records, oldest first.
+    */
+    virtual void write_batch(const TraceRecord* records, size_t count) = 0;
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    SpscRing<TraceRecord> ring{RING_SIZE};
+
+    /*
+        last_time:
+            The time of the last record pushed, for the deltas.
+    */
+    SimTime last_time = 0;
+
+    /*
+        done:
+            Set by close() to tell the background thread to finish.
+    */
+    std::atomic<bool> done{false};
+
+    std::thread worker;
+
+    /*
+        drain():
+            The body of the background thread.
+    */
+    void drain();
+
+    /*
+        advance(time):
+            Moves last_time to time and returns the delta to store in the next record,
+            pushing a CLOCK record first if the delta does not fit.
+    */
+    uint32_t advance(SimTime time) {
+        SimTime delta = time - this->last_time;
+        this->last_time = time;
+        if (delta >= 0 && delta <= (SimTime) UINT32_MAX) {
+            return (uint32_t) delta;
+        }
+
+        TraceRecord clock;
+        clock.kind = TraceRecord::CLOCK;
+        clock.set_wide(0, time);
+        this->ring.push(clock);
+        return 0;
+    }
+};
+
+/*
+    TraceWriter:
+        Records the verbose output of a simulation to a file as a compact binary trace.
+
+        The file starts with the 8 byte magic "CPUSIMTR", the number of threads n
+        (uint32), and the thread table: n entries of process ID (int32), thread ID
+        (int32) and priority (int32), indexed by thread handle. The records follow
+        until the end of the file. Values are in the byte order of the writing machine.
+*/
+
+class TraceWriter : public TraceRecorder {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        TraceWriter(filename, workload):
+            Opens filename, writes the header for the given workload and starts the
+            writer thread. Throws std::logic_error if the file cannot be opened.
+    */
+    TraceWriter(const std::string& filename, const Workload& workload);
+
+    /*
+        close():
+            Waits for every record to be written and closes the file. Called by the
+            destructor if it was not called before.
+    */
+    void close();
+
+    ~TraceWriter();
+
+protected:
+
+    void write_batch(const TraceRecord* records, size_t count) override;
+
+private:
+
+    std::ofstream file;
+};
+
+/*
+    TraceDecoder:
+        Turns trace records back into the logger output they stand for.
+*/
+
+class TraceDecoder {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        TraceDecoder(logger):
+            A decoder printing through logger. Threads are added with add_thread, in
+            handle order.
+    */
+    TraceDecoder(const Logger& logger) : logger(logger) {}
+
+    /*
+        add_thread(process_id, thread_id, priority):
+            Adds the next entry of the thread table.
+    */
+    void add_thread(int process_id, int thread_id, ProcessPriority priority) {
+        this->threads.emplace_back(0, thread_id, process_id, priority);
+    }
+
+    /*
+        decode(records, count):
+            Prints the given records, which follow the ones decoded so far. Throws
+            std::logic_error on a record for a thread not in the table.
+    */
+    void decode(const TraceRecord* records, size_t count);
+
+private:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    Logger logger;
+
+    /*
+        threads:
+            Stand-ins for the traced threads, carrying what the logger prints about them.
+    */
+    std::vector<Thread> threads;
+
+    /*
+        time:
+            The time of the last record decoded.
+    */
+    SimTime time = 0;
+};
+
+/*
+    AsyncLogger:
+        Moves the formatting and writing of log output off the simulation thread: the
+        simulation records compact trace records and a background thread prints them
+        through a copy of the simulation's logger, exactly as it would have.
+*/
+
+class AsyncLogger : public TraceRecorder {
+public:
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        AsyncLogger(logger, workload):
+            Starts printing records through logger, for a run of workload.
+    */
+    AsyncLogger(const Logger& logger, const Workload& workload);
+
+    ~AsyncLogger();
+
+protected:
+
+    void write_batch(const TraceRecord* records, size_t count) override;
+
+private:
+
+    TraceDecoder decoder;
+};
+
+/*
+    decode_trace(input, logger):
+        Reads a binary trace and prints it through logger (which should be verbose),
+        reproducing the verbose output of the traced run. Throws std::logic_error if
+        input is not a trace.
+*/
+void decode_trace(std::istream& input, const Logger& logger);
+
+#endif
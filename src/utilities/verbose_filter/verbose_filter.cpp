@@ -0,0 +1,100 @@
+#include "utilities/verbose_filter/verbose_filter.hpp"
+
+#include <cctype>
+#include <sstream>
+
+// Splits a comma-separated list into its (non-empty) items.
+static std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Parses a whole string as an integer.
+static bool parse_integer(const std::string& text, int64_t& value) {
+    try {
+        size_t end;
+        value = std::stoll(text, &end);
+        return end == text.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+// Parses a list of IDs into a sorted vector.
+static bool parse_ids(const std::string& list, std::vector<int>& ids) {
+    ids.clear();
+    for (const std::string& item : split_list(list)) {
+        int64_t id;
+        if (!parse_integer(item, id)) {
+            return false;
+        }
+        ids.push_back((int) id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return !ids.empty();
+}
+
+// Parses a list of names (or their numbers) into a bit mask.
+static bool parse_names(const std::string& list, const char* const names[], int num_names, uint32_t& mask) {
+    mask = 0;
+    for (std::string item : split_list(list)) {
+        std::transform(item.begin(), item.end(), item.begin(), ::toupper);
+
+        int64_t value = -1;
+        if (!parse_integer(item, value)) {
+            for (int i = 0; i < num_names; ++i) {
+                if (item == names[i]) {
+                    value = i;
+                }
+            }
+        }
+
+        if (value < 0 || value >= num_names) {
+            return false;
+        }
+        mask |= 1u << value;
+    }
+    return mask != 0;
+}
+
+bool VerboseFilter::parse_processes(const std::string& list) {
+    return parse_ids(list, this->process_ids);
+}
+
+bool VerboseFilter::parse_threads(const std::string& list) {
+    return parse_ids(list, this->thread_ids);
+}
+
+bool VerboseFilter::parse_priorities(const std::string& list) {
+    return parse_names(list, PROCESS_PRIORITY_NAMES, NUM_PROCESS_PRIORITIES, this->priority_mask);
+}
+
+bool VerboseFilter::parse_events(const std::string& list) {
+    return parse_names(list, EVENT_TYPE_NAMES, NUM_EVENT_TYPES, this->event_mask);
+}
+
+bool VerboseFilter::parse_time_range(const std::string& range) {
+    size_t colon = range.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::string start = range.substr(0, colon);
+    std::string end = range.substr(colon + 1);
+
+    if (!start.empty() && !parse_integer(start, this->start_time)) {
+        return false;
+    }
+    if (!end.empty() && !parse_integer(end, this->end_time)) {
+        return false;
+    }
+    return this->start_time <= this->end_time;
+}
@@ -0,0 +1,101 @@
+#ifndef VERBOSE_FILTER_HPP
+#define VERBOSE_FILTER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types/enums.hpp"
+#include "types/event/event.hpp"
+#include "types/thread/thread.hpp"
+
+/*
+    VerboseFilter:
+        Selects which blocks of the verbose output are printed, by process ID, thread
+        ID, priority, event type and time range. A block is printed only if it passes
+        every criterion that was set; with none set, everything is printed.
+
+        The checks only look at the raw fields of the event and thread (bit masks, a
+        binary search and two comparisons), so blocks that are filtered out are never
+        formatted.
+*/
+
+class VerboseFilter {
+public:
+
+    //==================================================
+    //  Member variables
+    //==================================================
+
+    /*
+        process_ids, thread_ids:
+            The IDs to print, sorted, or empty to print all of them.
+    */
+    std::vector<int> process_ids;
+    std::vector<int> thread_ids;
+
+    /*
+        priority_mask, event_mask:
+            Bit (1 << value) is set for each priority and event type to print.
+    */
+    uint32_t priority_mask = ~0u;
+    uint32_t event_mask = ~0u;
+
+    /*
+        start_time, end_time:
+            Only events with start_time <= time <= end_time are printed.
+    */
+    SimTime start_time = 0;
+    SimTime end_time = SIM_TIME_MAX;
+
+    //==================================================
+    //  Member functions
+    //==================================================
+
+    /*
+        matches(event, thread):
+            Whether the verbose block for event, about thread, should be printed.
+    */
+    bool matches(const Event& event, const Thread* thread) const {
+        return (this->event_mask & (1u << event.type))
+            && (this->priority_mask & (1u << thread->priority))
+            && event.time >= this->start_time
+            && event.time <= this->end_time
+            && (this->process_ids.empty() || std::binary_search(this->process_ids.begin(), this->process_ids.end(), thread->process_id))
+            && (this->thread_ids.empty() || std::binary_search(this->thread_ids.begin(), this->thread_ids.end(), thread->thread_id));
+    }
+
+    /*
+        parse_processes(list), parse_threads(list):
+            Restricts the output to a comma-separated list of IDs, e.g. "1,4,7".
+            Return false if the list is malformed.
+    */
+    bool parse_processes(const std::string& list);
+    bool parse_threads(const std::string& list);
+
+    /*
+        parse_priorities(list):
+            Restricts the output to a comma-separated list of priorities, by name
+            (SYSTEM, INTERACTIVE, NORMAL, BATCH) or number. Returns false if the list
+            is malformed.
+    */
+    bool parse_priorities(const std::string& list);
+
+    /*
+        parse_events(list):
+            Restricts the output to a comma-separated list of event types, by name
+            (e.g. THREAD_ARRIVED,DISPATCHER_INVOKED). Returns false if the list is
+            malformed.
+    */
+    bool parse_events(const std::string& list);
+
+    /*
+        parse_time_range(range):
+            Restricts the output to a time range "start:end", where either end may be
+            left out ("100:" or ":500"). Returns false if the range is malformed.
+    */
+    bool parse_time_range(const std::string& range);
+};
+
+#endif
@@ -27,3 +27,19 @@ do
 	done
 done
 
+
+# Branching from a PRIORITY prefix: at time 50 the BATCH thread (ready since 10) and the
+# SYSTEM thread (ready since 20) are waiting, so FCFS and RR must run the BATCH one first.
+SIM_COMMAND="./cpu-sim -c -a PRIORITY --branch_at 50 tests/input/input-branch"
+outputfilename=tests/output/output-branch.c
+echo Executing $SIM_COMMAND
+$SIM_COMMAND &> my_output
+DIFF=$(diff -b -B my_output $outputfilename)
+if [ "$DIFF" != "" ]
+then
+	diff -b -B my_output $outputfilename > my_output.diff
+	echo "   The output does not match $outputfilename Please check my_output and my_output.diff for details."
+	exit
+else
+	echo "   Test passed!"
+fi
@@ -0,0 +1,31 @@
+Comparison against FCFS:
+                                  FCFS                      RR                PRIORITY            
+SYSTEM THREADS:
+    Total Count:                     1                       1 (+0.00%)              1 (+0.00%)   
+    Avg. response time:          91.00                   37.00 (-59.34%)         84.00 (-7.69%)   
+    Avg. turnaround time:        96.00                   53.00 (-44.79%)         89.00 (-7.29%)   
+
+INTERACTIVE THREADS:
+    Total Count:                     0                       0 (+0.00%)              0 (+0.00%)   
+    Avg. response time:           0.00                    0.00 (+0.00%)           0.00 (+0.00%)   
+    Avg. turnaround time:         0.00                    0.00 (+0.00%)           0.00 (+0.00%)   
+
+NORMAL THREADS:
+    Total Count:                     1                       1 (+0.00%)              1 (+0.00%)   
+    Avg. response time:           2.00                    2.00 (+0.00%)           2.00 (+0.00%)   
+    Avg. turnaround time:       102.00                  140.00 (+37.25%)        102.00 (+0.00%)   
+
+BATCH THREADS:
+    Total Count:                     1                       1 (+0.00%)              1 (+0.00%)   
+    Avg. response time:          94.00                   42.00 (-55.32%)        101.00 (+7.45%)   
+    Avg. turnaround time:        99.00                   59.00 (-40.40%)        106.00 (+7.07%)   
+
+Total elapsed time:                116                     140 (+20.69%)           116 (+0.00%)   
+Total service time:                110                     110 (+0.00%)            110 (+0.00%)   
+Total I/O time:                      0                       0 (+0.00%)              0 (+0.00%)   
+Total dispatch time:                 6                      30 (+400.00%)            6 (+0.00%)   
+Total idle time:                     0                       0 (+0.00%)              0 (+0.00%)   
+
+CPU utilization (%):            100.00                  100.00 (+0.00%)         100.00 (+0.00%)   
+CPU efficiency (%):              94.83                   78.57 (-17.14%)         94.83 (+0.00%)   
+